@@ -0,0 +1,464 @@
+// dear imgui: Renderer Backend for OpenGL ES 2.0 and desktop OpenGL 2.0+ (shaders, streaming VBO/IBO)
+// This needs to be used along with a Platform Backend (e.g. GLFW, SDL, Win32, custom..)
+
+// Implemented features:
+//  [X] Renderer: User texture binding. Use 'GLuint' OpenGL texture identifier as void*/ImTextureID. Read the FAQ about ImTextureID!
+//  [X] Renderer: One texture can be flagged as a signed distance field and is drawn through a second shader.
+//  [ ] Renderer: Textures are sampled for alpha (coverage) only, which is all the dash draws: the GL_ALPHA font atlas and the SDF atlas.
+//  [ ] Renderer: Large meshes support (64k+ vertices) with 16-bit indices.
+
+// Differences from imgui_impl_opengl2, which this replaces on GPUs where fixed function GL is emulated:
+//  - Vertices and indices go through one VBO/IBO pair created once. Each frame orphans them with glBufferData(nullptr)
+//    and fills them with a glBufferSubData() per draw list, so the driver never waits on the GPU still reading
+//    last frame's data and there are no client side arrays to copy at every draw call.
+//  - A two line vertex shader does the projection from a scale/translate uniform, only updated when the display size changes.
+//  - No glGet*() backup/restore around the frame, and texture/program binds are skipped when unchanged.
+
+// CHANGELOG
+//  2026-10-17: Initial version, based on imgui_impl_opengl2.cpp.
+
+#include "imgui.h"
+#ifndef IMGUI_DISABLE
+#include "imgui_impl_gles2.h"
+#include <stdint.h>     // intptr_t
+#include <stdio.h>
+#include <string.h>
+
+#if defined(IMGUI_IMPL_OPENGL_ES2)
+#include <GLES2/gl2.h>
+#else
+#define GL_GLEXT_PROTOTYPES // GL 2.0 entry points are exported by libGL on Linux
+#include <GL/gl.h>
+#include <GL/glext.h>
+#endif
+
+// GLES2 has no 32-bit indices without an extension
+static_assert(sizeof(ImDrawIdx) == 2, "imgui_impl_gles2 needs 16-bit ImDrawIdx");
+
+// Fixed attribute locations, shared by both programs so switching between them keeps the vertex setup
+enum { ATTRIB_POSITION = 0, ATTRIB_UV = 1, ATTRIB_COLOR = 2 };
+
+struct ImGui_ImplGLES2_Data
+{
+    char            GlslVersionString[32];
+    GLuint          FontTexture;
+    GLuint          ShaderHandle;           // Alpha coverage, everything but the distance field texture
+    GLuint          SdfShaderHandle;
+    GLint           UniformLocationScaleTranslate[2];
+    GLuint          VboHandle, ElementsHandle;
+    GLsizeiptr      VertexBufferSize;
+    GLsizeiptr      IndexBufferSize;
+    GLuint          DistanceFieldTexture;
+    float           LastScaleTranslate[4];  // Projection both programs were last given, all zero until the first frame
+
+    // Bound during RenderDrawData(), forgotten after every user callback
+    GLuint          BoundTexture;
+    GLuint          BoundProgram;
+
+    ImGui_ImplGLES2_Data() { memset((void*)this, 0, sizeof(*this)); }
+};
+
+// Backend data stored in io.BackendRendererUserData to allow support for multiple Dear ImGui contexts
+static ImGui_ImplGLES2_Data* ImGui_ImplGLES2_GetBackendData()
+{
+    return ImGui::GetCurrentContext() ? (ImGui_ImplGLES2_Data*)ImGui::GetIO().BackendRendererUserData : nullptr;
+}
+
+// Functions
+bool    ImGui_ImplGLES2_Init(const char* glsl_version)
+{
+    ImGuiIO& io = ImGui::GetIO();
+    IM_ASSERT(io.BackendRendererUserData == nullptr && "Already initialized a renderer backend!");
+
+    ImGui_ImplGLES2_Data* bd = IM_NEW(ImGui_ImplGLES2_Data)();
+    io.BackendRendererUserData = (void*)bd;
+    io.BackendRendererName = "imgui_impl_gles2";
+
+    if (glsl_version == nullptr)
+    {
+#if defined(IMGUI_IMPL_OPENGL_ES2)
+        glsl_version = "#version 100";
+#else
+        glsl_version = "#version 110";
+#endif
+    }
+    IM_ASSERT((int)strlen(glsl_version) + 2 < IM_ARRAYSIZE(bd->GlslVersionString));
+    strcpy(bd->GlslVersionString, glsl_version);
+    strcat(bd->GlslVersionString, "\n");
+
+    return true;
+}
+
+void    ImGui_ImplGLES2_Shutdown()
+{
+    ImGui_ImplGLES2_Data* bd = ImGui_ImplGLES2_GetBackendData();
+    IM_ASSERT(bd != nullptr && "No renderer backend to shutdown, or already shutdown?");
+    ImGuiIO& io = ImGui::GetIO();
+
+    ImGui_ImplGLES2_DestroyDeviceObjects();
+    io.BackendRendererName = nullptr;
+    io.BackendRendererUserData = nullptr;
+    IM_DELETE(bd);
+}
+
+void    ImGui_ImplGLES2_NewFrame()
+{
+    ImGui_ImplGLES2_Data* bd = ImGui_ImplGLES2_GetBackendData();
+    IM_ASSERT(bd != nullptr && "Did you call ImGui_ImplGLES2_Init()?");
+
+    if (!bd->ShaderHandle)
+        ImGui_ImplGLES2_CreateDeviceObjects();
+    if (!bd->FontTexture)
+        ImGui_ImplGLES2_CreateFontsTexture();
+}
+
+bool    ImGui_ImplGLES2_SetDistanceFieldTexture(ImTextureID texture_id)
+{
+    ImGui_ImplGLES2_Data* bd = ImGui_ImplGLES2_GetBackendData();
+    bd->DistanceFieldTexture = (GLuint)(intptr_t)texture_id;
+    return bd->SdfShaderHandle != 0;
+}
+
+static void ImGui_ImplGLES2_SetupVertexAttribs(GLintptr vtx_offset)
+{
+    glVertexAttribPointer(ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert), (const GLvoid*)(vtx_offset + offsetof(ImDrawVert, pos)));
+    glVertexAttribPointer(ATTRIB_UV, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert), (const GLvoid*)(vtx_offset + offsetof(ImDrawVert, uv)));
+    glVertexAttribPointer(ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ImDrawVert), (const GLvoid*)(vtx_offset + offsetof(ImDrawVert, col)));
+}
+
+static void ImGui_ImplGLES2_SetupRenderState(ImDrawData* draw_data, int fb_width, int fb_height)
+{
+    ImGui_ImplGLES2_Data* bd = ImGui_ImplGLES2_GetBackendData();
+
+    // Setup render state: alpha-blending enabled, no face culling, no depth testing, scissor enabled
+    glEnable(GL_BLEND);
+    glBlendEquation(GL_FUNC_ADD);
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    glDisable(GL_CULL_FACE);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_STENCIL_TEST);
+    glEnable(GL_SCISSOR_TEST);
+    glViewport(0, 0, (GLsizei)fb_width, (GLsizei)fb_height);
+    glActiveTexture(GL_TEXTURE0);
+
+    // Orthographic projection as scale/translate from DisplayPos..DisplayPos+DisplaySize to clip space, Y flipped.
+    // Both programs get it, but only when it changes, which for the dash is the first frame.
+    float L = draw_data->DisplayPos.x;
+    float T = draw_data->DisplayPos.y;
+    const float scale_translate[4] =
+    {
+        2.0f / draw_data->DisplaySize.x, -2.0f / draw_data->DisplaySize.y,
+        -1.0f - L * 2.0f / draw_data->DisplaySize.x, 1.0f + T * 2.0f / draw_data->DisplaySize.y,
+    };
+    if (memcmp(scale_translate, bd->LastScaleTranslate, sizeof(scale_translate)) != 0)
+    {
+        const GLuint programs[2] = { bd->ShaderHandle, bd->SdfShaderHandle };
+        for (int i = 0; i < 2; i++)
+        {
+            if (!programs[i])
+                continue;
+            glUseProgram(programs[i]);
+            glUniform4fv(bd->UniformLocationScaleTranslate[i], 1, scale_translate);
+        }
+        memcpy(bd->LastScaleTranslate, scale_translate, sizeof(scale_translate));
+    }
+    glUseProgram(bd->ShaderHandle);
+    bd->BoundProgram = bd->ShaderHandle;
+    bd->BoundTexture = 0;
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, bd->VboHandle);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bd->ElementsHandle);
+    glEnableVertexAttribArray(ATTRIB_POSITION);
+    glEnableVertexAttribArray(ATTRIB_UV);
+    glEnableVertexAttribArray(ATTRIB_COLOR);
+}
+
+// GLES2 Render function.
+void    ImGui_ImplGLES2_RenderDrawData(ImDrawData* draw_data)
+{
+    // Avoid rendering when minimized, scale coordinates for retina displays (screen coordinates != framebuffer coordinates)
+    int fb_width = (int)(draw_data->DisplaySize.x * draw_data->FramebufferScale.x);
+    int fb_height = (int)(draw_data->DisplaySize.y * draw_data->FramebufferScale.y);
+    if (fb_width <= 0 || fb_height <= 0 || draw_data->TotalVtxCount == 0)
+        return;
+
+    ImGui_ImplGLES2_Data* bd = ImGui_ImplGLES2_GetBackendData();
+    ImGui_ImplGLES2_SetupRenderState(draw_data, fb_width, fb_height);
+
+    // Upload the whole frame. Orphaning with glBufferData(nullptr) hands us fresh storage while the GPU may still be
+    // drawing from last frame's; the buffers only ever grow so the allocation size is stable after the first frames.
+    GLsizeiptr vtx_size = (GLsizeiptr)draw_data->TotalVtxCount * (GLsizeiptr)sizeof(ImDrawVert);
+    GLsizeiptr idx_size = (GLsizeiptr)draw_data->TotalIdxCount * (GLsizeiptr)sizeof(ImDrawIdx);
+    if (vtx_size > bd->VertexBufferSize)
+        bd->VertexBufferSize = vtx_size + vtx_size / 2;
+    if (idx_size > bd->IndexBufferSize)
+        bd->IndexBufferSize = idx_size + idx_size / 2;
+    glBufferData(GL_ARRAY_BUFFER, bd->VertexBufferSize, nullptr, GL_STREAM_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, bd->IndexBufferSize, nullptr, GL_STREAM_DRAW);
+    GLintptr vtx_offset = 0;
+    GLintptr idx_offset = 0;
+    for (int n = 0; n < draw_data->CmdListsCount; n++)
+    {
+        const ImDrawList* cmd_list = draw_data->CmdLists[n];
+        GLsizeiptr list_vtx_size = (GLsizeiptr)cmd_list->VtxBuffer.Size * (GLsizeiptr)sizeof(ImDrawVert);
+        GLsizeiptr list_idx_size = (GLsizeiptr)cmd_list->IdxBuffer.Size * (GLsizeiptr)sizeof(ImDrawIdx);
+        glBufferSubData(GL_ARRAY_BUFFER, vtx_offset, list_vtx_size, (const GLvoid*)cmd_list->VtxBuffer.Data);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, idx_offset, list_idx_size, (const GLvoid*)cmd_list->IdxBuffer.Data);
+        vtx_offset += list_vtx_size;
+        idx_offset += list_idx_size;
+    }
+
+    // Will project scissor/clipping rectangles into framebuffer space
+    ImVec2 clip_off = draw_data->DisplayPos;         // (0,0) unless using multi-viewports
+    ImVec2 clip_scale = draw_data->FramebufferScale; // (1,1) unless using retina display which are often (2,2)
+
+    // Render command lists. Indices are relative to their own list, so the attribute pointers move to each list's
+    // vertices instead (GLES2 has no base vertex draw).
+    vtx_offset = 0;
+    idx_offset = 0;
+    for (int n = 0; n < draw_data->CmdListsCount; n++)
+    {
+        const ImDrawList* cmd_list = draw_data->CmdLists[n];
+        ImGui_ImplGLES2_SetupVertexAttribs(vtx_offset);
+
+        for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
+        {
+            const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
+            if (pcmd->UserCallback)
+            {
+                // User callback, registered via ImDrawList::AddCallback()
+                // (ImDrawCallback_ResetRenderState is a special callback value used by the user to request the renderer to reset render state.)
+                if (pcmd->UserCallback == ImDrawCallback_ResetRenderState)
+                {
+                    ImGui_ImplGLES2_SetupRenderState(draw_data, fb_width, fb_height);
+                    ImGui_ImplGLES2_SetupVertexAttribs(vtx_offset);
+                }
+                else
+                {
+                    pcmd->UserCallback(cmd_list, pcmd);
+                    bd->BoundTexture = 0;
+                    bd->BoundProgram = 0;
+                }
+            }
+            else
+            {
+                // Project scissor/clipping rectangles into framebuffer space
+                ImVec2 clip_min((pcmd->ClipRect.x - clip_off.x) * clip_scale.x, (pcmd->ClipRect.y - clip_off.y) * clip_scale.y);
+                ImVec2 clip_max((pcmd->ClipRect.z - clip_off.x) * clip_scale.x, (pcmd->ClipRect.w - clip_off.y) * clip_scale.y);
+                if (clip_max.x <= clip_min.x || clip_max.y <= clip_min.y)
+                    continue;
+
+                // Apply scissor/clipping rectangle (Y is inverted in OpenGL)
+                glScissor((int)clip_min.x, (int)((float)fb_height - clip_max.y), (int)(clip_max.x - clip_min.x), (int)(clip_max.y - clip_min.y));
+
+                // Bind texture and the program for it, Draw
+                GLuint texture = (GLuint)(intptr_t)pcmd->GetTexID();
+                if (texture != bd->BoundTexture)
+                {
+                    glBindTexture(GL_TEXTURE_2D, texture);
+                    bd->BoundTexture = texture;
+                }
+                GLuint program = (texture == bd->DistanceFieldTexture && texture != 0 && bd->SdfShaderHandle) ? bd->SdfShaderHandle : bd->ShaderHandle;
+                if (program != bd->BoundProgram)
+                {
+                    glUseProgram(program);
+                    bd->BoundProgram = program;
+                }
+                glDrawElements(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, GL_UNSIGNED_SHORT, (const GLvoid*)(idx_offset + pcmd->IdxOffset * sizeof(ImDrawIdx)));
+            }
+        }
+        vtx_offset += (GLintptr)cmd_list->VtxBuffer.Size * (GLintptr)sizeof(ImDrawVert);
+        idx_offset += (GLintptr)cmd_list->IdxBuffer.Size * (GLintptr)sizeof(ImDrawIdx);
+    }
+
+    // The one piece of state not left as is: a scissored glClear() next frame would only clear the last clip rect
+    glDisable(GL_SCISSOR_TEST);
+}
+
+bool    ImGui_ImplGLES2_CreateFontsTexture()
+{
+    // Build texture atlas
+    ImGuiIO& io = ImGui::GetIO();
+    ImGui_ImplGLES2_Data* bd = ImGui_ImplGLES2_GetBackendData();
+    unsigned char* pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsAlpha8(&pixels, &width, &height);   // Coverage only, the shader takes its alpha and keeps the vertex color
+
+    // Upload texture to graphics system. GL defaults are assumed rather than read back, as everywhere in this backend.
+    // (Bilinear sampling is required by default. Set 'io.Fonts->Flags |= ImFontAtlasFlags_NoBakedLines' or 'style.AntiAliasedLinesUseTex = false' to allow point/nearest sampling)
+    glGenTextures(1, &bd->FontTexture);
+    glBindTexture(GL_TEXTURE_2D, bd->FontTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, width, height, 0, GL_ALPHA, GL_UNSIGNED_BYTE, pixels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // Store our identifier
+    io.Fonts->SetTexID((ImTextureID)(intptr_t)bd->FontTexture);
+
+    return true;
+}
+
+void    ImGui_ImplGLES2_DestroyFontsTexture()
+{
+    ImGuiIO& io = ImGui::GetIO();
+    ImGui_ImplGLES2_Data* bd = ImGui_ImplGLES2_GetBackendData();
+    if (bd->FontTexture)
+    {
+        glDeleteTextures(1, &bd->FontTexture);
+        io.Fonts->SetTexID(0);
+        bd->FontTexture = 0;
+    }
+}
+
+static bool CheckShader(GLuint handle, const char* desc)
+{
+    GLint status = 0;
+    glGetShaderiv(handle, GL_COMPILE_STATUS, &status);
+    if ((GLboolean)status == GL_FALSE)
+    {
+        char log[1024];
+        glGetShaderInfoLog(handle, sizeof(log), nullptr, log);
+        fprintf(stderr, "ERROR: ImGui_ImplGLES2_CreateDeviceObjects: failed to compile %s!\n%s\n", desc, log);
+    }
+    return (GLboolean)status == GL_TRUE;
+}
+
+static bool CheckProgram(GLuint handle, const char* desc)
+{
+    GLint status = 0;
+    glGetProgramiv(handle, GL_LINK_STATUS, &status);
+    if ((GLboolean)status == GL_FALSE)
+    {
+        char log[1024];
+        glGetProgramInfoLog(handle, sizeof(log), nullptr, log);
+        fprintf(stderr, "ERROR: ImGui_ImplGLES2_CreateDeviceObjects: failed to link %s!\n%s\n", desc, log);
+    }
+    return (GLboolean)status == GL_TRUE;
+}
+
+// Builds a program from the shared vertex shader, 0 on failure
+static GLuint CreateProgram(GLuint vert_handle, const char* fragment_shader, const char* desc, GLint* scale_translate_location)
+{
+    ImGui_ImplGLES2_Data* bd = ImGui_ImplGLES2_GetBackendData();
+    const GLchar* fragment_shader_with_version[2] = { bd->GlslVersionString, fragment_shader };
+    GLuint frag_handle = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(frag_handle, 2, fragment_shader_with_version, nullptr);
+    glCompileShader(frag_handle);
+    if (!CheckShader(frag_handle, desc))
+    {
+        glDeleteShader(frag_handle);
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vert_handle);
+    glAttachShader(program, frag_handle);
+    glBindAttribLocation(program, ATTRIB_POSITION, "Position");
+    glBindAttribLocation(program, ATTRIB_UV, "UV");
+    glBindAttribLocation(program, ATTRIB_COLOR, "Color");
+    glLinkProgram(program);
+    glDetachShader(program, vert_handle);
+    glDetachShader(program, frag_handle);
+    glDeleteShader(frag_handle);
+    if (!CheckProgram(program, desc))
+    {
+        glDeleteProgram(program);
+        return 0;
+    }
+
+    glUseProgram(program);
+    glUniform1i(glGetUniformLocation(program, "Texture"), 0);
+    *scale_translate_location = glGetUniformLocation(program, "ScaleTranslate");
+    glUseProgram(0);
+    return program;
+}
+
+bool    ImGui_ImplGLES2_CreateDeviceObjects()
+{
+    ImGui_ImplGLES2_Data* bd = ImGui_ImplGLES2_GetBackendData();
+
+    const GLchar* vertex_shader =
+        "uniform vec4 ScaleTranslate;\n"
+        "attribute vec2 Position;\n"
+        "attribute vec2 UV;\n"
+        "attribute vec4 Color;\n"
+        "varying vec2 Frag_UV;\n"
+        "varying vec4 Frag_Color;\n"
+        "void main()\n"
+        "{\n"
+        "    Frag_UV = UV;\n"
+        "    Frag_Color = Color;\n"
+        "    gl_Position = vec4(Position * ScaleTranslate.xy + ScaleTranslate.zw, 0.0, 1.0);\n"
+        "}\n";
+
+    const GLchar* fragment_shader =
+        "#ifdef GL_ES\n"
+        "precision mediump float;\n"
+        "#endif\n"
+        "uniform sampler2D Texture;\n"
+        "varying vec2 Frag_UV;\n"
+        "varying vec4 Frag_Color;\n"
+        "void main()\n"
+        "{\n"
+        "    gl_FragColor = vec4(Frag_Color.rgb, Frag_Color.a * texture2D(Texture, Frag_UV.st).a);\n"
+        "}\n";
+
+    // fwidth() keeps the soft edge about a screen pixel wide whatever size the glyphs are drawn at
+    const GLchar* sdf_fragment_shader =
+        "#ifdef GL_ES\n"
+        "#extension GL_OES_standard_derivatives : enable\n"
+        "precision mediump float;\n"
+        "#endif\n"
+        "uniform sampler2D Texture;\n"
+        "varying vec2 Frag_UV;\n"
+        "varying vec4 Frag_Color;\n"
+        "void main()\n"
+        "{\n"
+        "    float distance = texture2D(Texture, Frag_UV.st).a;\n"
+        "    float smoothing = 0.7 * fwidth(distance);\n"
+        "    gl_FragColor = vec4(Frag_Color.rgb, Frag_Color.a * smoothstep(0.5 - smoothing, 0.5 + smoothing, distance));\n"
+        "}\n";
+
+    const GLchar* vertex_shader_with_version[2] = { bd->GlslVersionString, vertex_shader };
+    GLuint vert_handle = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vert_handle, 2, vertex_shader_with_version, nullptr);
+    glCompileShader(vert_handle);
+    if (!CheckShader(vert_handle, "vertex shader"))
+    {
+        glDeleteShader(vert_handle);
+        return false;
+    }
+    bd->ShaderHandle = CreateProgram(vert_handle, fragment_shader, "fragment shader", &bd->UniformLocationScaleTranslate[0]);
+    bd->SdfShaderHandle = CreateProgram(vert_handle, sdf_fragment_shader, "distance field fragment shader", &bd->UniformLocationScaleTranslate[1]);
+    glDeleteShader(vert_handle);
+    if (!bd->ShaderHandle)
+        return false;
+
+    glGenBuffers(1, &bd->VboHandle);
+    glGenBuffers(1, &bd->ElementsHandle);
+    bd->VertexBufferSize = 0;
+    bd->IndexBufferSize = 0;
+    memset(bd->LastScaleTranslate, 0, sizeof(bd->LastScaleTranslate));
+
+    return true;
+}
+
+void    ImGui_ImplGLES2_DestroyDeviceObjects()
+{
+    ImGui_ImplGLES2_Data* bd = ImGui_ImplGLES2_GetBackendData();
+    if (bd->VboHandle)          { glDeleteBuffers(1, &bd->VboHandle); bd->VboHandle = 0; }
+    if (bd->ElementsHandle)     { glDeleteBuffers(1, &bd->ElementsHandle); bd->ElementsHandle = 0; }
+    if (bd->ShaderHandle)       { glDeleteProgram(bd->ShaderHandle); bd->ShaderHandle = 0; }
+    if (bd->SdfShaderHandle)    { glDeleteProgram(bd->SdfShaderHandle); bd->SdfShaderHandle = 0; }
+    ImGui_ImplGLES2_DestroyFontsTexture();
+}
+
+//-----------------------------------------------------------------------------
+
+#endif // #ifndef IMGUI_DISABLE
@@ -0,0 +1,40 @@
+// dear imgui: Renderer Backend for OpenGL ES 2.0 and desktop OpenGL 2.0+ (shaders, streaming VBO/IBO)
+// This needs to be used along with a Platform Backend (e.g. GLFW, SDL, Win32, custom..)
+
+// Implemented features:
+//  [X] Renderer: User texture binding. Use 'GLuint' OpenGL texture identifier as void*/ImTextureID. Read the FAQ about ImTextureID!
+//  [X] Renderer: One texture can be flagged as a signed distance field and is drawn through a second shader.
+//  [ ] Renderer: Textures are sampled for alpha (coverage) only, which is all the dash draws: the GL_ALPHA font atlas and the SDF atlas.
+//  [ ] Renderer: Large meshes support (64k+ vertices) with 16-bit indices.
+
+// Written for a dash that owns its GL context, so unlike imgui_impl_opengl2 it does not read back and restore
+// GL state around each frame: those glGet*() calls stall the pipeline on Mesa/VideoCore drivers. State is set,
+// never queried, and left bound after ImGui_ImplGLES2_RenderDrawData(), apart from the scissor test which is switched
+// off again. Code drawing with GL between frames has to set up whatever else it needs itself (a glUseProgram(0) is
+// enough for fixed function drawing).
+//
+// Build with IMGUI_IMPL_OPENGL_ES2 defined for a GLES2 context (GLES2/gl2.h, link -lGLESv2). Otherwise it runs on
+// a desktop GL 2.0+ compatibility context through the GL/glext.h prototypes libGL exports on Linux.
+
+#pragma once
+#include "imgui.h"      // IMGUI_IMPL_API
+#ifndef IMGUI_DISABLE
+
+// glsl_version defaults to "#version 100" for GLES2 and "#version 110" for desktop GL
+IMGUI_IMPL_API bool     ImGui_ImplGLES2_Init(const char* glsl_version = nullptr);
+IMGUI_IMPL_API void     ImGui_ImplGLES2_Shutdown();
+IMGUI_IMPL_API void     ImGui_ImplGLES2_NewFrame();
+IMGUI_IMPL_API void     ImGui_ImplGLES2_RenderDrawData(ImDrawData* draw_data);
+
+// Draws texture_id as a distance field (edge at 0.5 alpha, softened over a screen pixel) instead of plain coverage.
+// Needs the device objects; returns false if the distance field shader failed to build.
+IMGUI_IMPL_API bool     ImGui_ImplGLES2_SetDistanceFieldTexture(ImTextureID texture_id);
+
+// Called by Init/NewFrame/Shutdown. Device objects are the shaders and buffers, the font texture is separate so the
+// shaders can be built (and SetDistanceFieldTexture() checked) before the font atlas is.
+IMGUI_IMPL_API bool     ImGui_ImplGLES2_CreateFontsTexture();
+IMGUI_IMPL_API void     ImGui_ImplGLES2_DestroyFontsTexture();
+IMGUI_IMPL_API bool     ImGui_ImplGLES2_CreateDeviceObjects();
+IMGUI_IMPL_API void     ImGui_ImplGLES2_DestroyDeviceObjects();
+
+#endif // #ifndef IMGUI_DISABLE
@@ -0,0 +1,581 @@
+// dear imgui: Platform Backend for direct DRM/KMS output (GBM + EGL, evdev keyboards), no X11/Wayland
+// This needs to be used along with a Renderer Backend (e.g. OpenGL2, GLES2)
+
+// Implemented features:
+//  [X] Platform: Keyboard support from every /dev/input/event* device with keys, with kernel event timestamps.
+//  [X] Platform: Page flipped, vsynced presentation; SwapBuffers() returns once the new frame is on screen.
+//  [ ] Platform: Mouse/touch input, text input, gamepads, hotplug of displays or keyboards.
+
+// CHANGELOG
+//  2026-10-17: Initial version.
+
+#include "imgui.h"
+#ifndef IMGUI_DISABLE
+#include "imgui_impl_kms.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <linux/input.h>
+
+#include <xf86drm.h>
+#include <xf86drmMode.h>
+#include <gbm.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#define KMS_MAX_KEYBOARDS 8
+
+struct ImGui_ImplKms_Data
+{
+    int                 DrmFd;
+    uint32_t            ConnectorId;
+    uint32_t            CrtcId;
+    drmModeModeInfo     Mode;
+    drmModeCrtc*        SavedCrtc;          // Whatever was on screen before us (fbcon), put back on exit
+    bool                ModeSet;
+    bool                FlipPending;
+    drmEventContext     EventContext;
+
+    gbm_device*         GbmDevice;
+    gbm_surface*        GbmSurface;
+    gbm_bo*             ScanoutBo;          // Buffer on screen now, released back to the surface after the next flip
+
+    EGLDisplay          EglDisplay;
+    EGLContext          EglContext;
+    EGLSurface          EglSurface;
+
+    int                 WakeFd;             // eventfd written by PostEmptyEvent()
+    int                 KeyboardFds[KMS_MAX_KEYBOARDS];
+    int                 KeyboardCount;
+    bool                ModifierDown[8];    // Left/right Ctrl, Shift, Alt, Super
+    uint64_t            PendingInputNs;
+    double              Time;
+};
+
+// One display per process, and it has to exist before the ImGui context, so no per-context backend data
+static ImGui_ImplKms_Data g_Kms;
+
+static void ImGui_ImplKms_PageFlipHandler(int, unsigned int, unsigned int, unsigned int, void* user_data)
+{
+    ((ImGui_ImplKms_Data*)user_data)->FlipPending = false;
+}
+
+static bool ImGui_ImplKms_FindOutput(ImGui_ImplKms_Data* bd)
+{
+    drmModeRes* resources = drmModeGetResources(bd->DrmFd);
+    if (!resources)
+        return false;
+
+    drmModeConnector* connector = nullptr;
+    for (int i = 0; i < resources->count_connectors && !connector; i++)
+    {
+        connector = drmModeGetConnector(bd->DrmFd, resources->connectors[i]);
+        if (connector && (connector->connection != DRM_MODE_CONNECTED || connector->count_modes == 0))
+        {
+            drmModeFreeConnector(connector);
+            connector = nullptr;
+        }
+    }
+    if (!connector)
+    {
+        drmModeFreeResources(resources);
+        return false;
+    }
+
+    bd->ConnectorId = connector->connector_id;
+    bd->Mode = connector->modes[0];
+    for (int i = 0; i < connector->count_modes; i++)
+        if (connector->modes[i].type & DRM_MODE_TYPE_PREFERRED)
+        {
+            bd->Mode = connector->modes[i];
+            break;
+        }
+
+    // The CRTC already driving the connector, else the first one any of its encoders can use
+    bd->CrtcId = 0;
+    drmModeEncoder* encoder = connector->encoder_id ? drmModeGetEncoder(bd->DrmFd, connector->encoder_id) : nullptr;
+    if (encoder)
+    {
+        bd->CrtcId = encoder->crtc_id;
+        drmModeFreeEncoder(encoder);
+    }
+    for (int i = 0; i < connector->count_encoders && !bd->CrtcId; i++)
+    {
+        encoder = drmModeGetEncoder(bd->DrmFd, connector->encoders[i]);
+        if (!encoder)
+            continue;
+        for (int c = 0; c < resources->count_crtcs && !bd->CrtcId; c++)
+            if (encoder->possible_crtcs & (1u << c))
+                bd->CrtcId = resources->crtcs[c];
+        drmModeFreeEncoder(encoder);
+    }
+
+    drmModeFreeConnector(connector);
+    drmModeFreeResources(resources);
+    if (!bd->CrtcId)
+        return false;
+    bd->SavedCrtc = drmModeGetCrtc(bd->DrmFd, bd->CrtcId);
+    return true;
+}
+
+static bool ImGui_ImplKms_CreateEglContext(ImGui_ImplKms_Data* bd)
+{
+    PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    bd->EglDisplay = get_platform_display ? get_platform_display(EGL_PLATFORM_GBM_KHR, bd->GbmDevice, nullptr) : eglGetDisplay((EGLNativeDisplayType)bd->GbmDevice);
+    if (bd->EglDisplay == EGL_NO_DISPLAY || !eglInitialize(bd->EglDisplay, nullptr, nullptr))
+        return false;
+
+#if defined(IMGUI_IMPL_OPENGL_ES2)
+    const EGLenum api = EGL_OPENGL_ES_API;
+    const EGLint renderable_type = EGL_OPENGL_ES2_BIT;
+    const EGLint context_attribs[] = { EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE };
+#else
+    const EGLenum api = EGL_OPENGL_API;
+    const EGLint renderable_type = EGL_OPENGL_BIT;
+    const EGLint context_attribs[] = { EGL_NONE };
+#endif
+    if (!eglBindAPI(api))
+        return false;
+
+    // Several configs match, the one scanout can use is the one whose visual is the GBM surface's format
+    const EGLint config_attribs[] =
+    {
+        EGL_SURFACE_TYPE, EGL_WINDOW_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 0,
+        EGL_RENDERABLE_TYPE, renderable_type,
+        EGL_NONE
+    };
+    EGLint config_count = 0;
+    if (!eglChooseConfig(bd->EglDisplay, config_attribs, nullptr, 0, &config_count) || config_count == 0)
+        return false;
+    ImVector<EGLConfig> configs;
+    configs.resize(config_count);
+    eglChooseConfig(bd->EglDisplay, config_attribs, configs.Data, config_count, &config_count);
+    EGLConfig config = nullptr;
+    for (int i = 0; i < config_count && !config; i++)
+    {
+        EGLint visual = 0;
+        if (eglGetConfigAttrib(bd->EglDisplay, configs[i], EGL_NATIVE_VISUAL_ID, &visual) && (uint32_t)visual == GBM_FORMAT_XRGB8888)
+            config = configs[i];
+    }
+    if (!config)
+        return false;
+
+    bd->EglContext = eglCreateContext(bd->EglDisplay, config, EGL_NO_CONTEXT, context_attribs);
+    if (bd->EglContext == EGL_NO_CONTEXT)
+        return false;
+    bd->EglSurface = eglCreateWindowSurface(bd->EglDisplay, config, (EGLNativeWindowType)bd->GbmSurface, nullptr);
+    if (bd->EglSurface == EGL_NO_SURFACE)
+        return false;
+    return eglMakeCurrent(bd->EglDisplay, bd->EglSurface, bd->EglSurface, bd->EglContext) == EGL_TRUE;
+}
+
+bool    ImGui_ImplKms_CreateDisplay(const char* drm_device)
+{
+    ImGui_ImplKms_Data* bd = &g_Kms;
+    IM_ASSERT(bd->DrmFd == 0 && "Already created a KMS display!");
+    memset((void*)bd, 0, sizeof(*bd));
+    bd->WakeFd = -1;
+
+    bd->DrmFd = open(drm_device, O_RDWR | O_CLOEXEC);
+    if (bd->DrmFd < 0)
+    {
+        perror(drm_device);
+        bd->DrmFd = 0;
+        return false;
+    }
+    if (!ImGui_ImplKms_FindOutput(bd))
+    {
+        fprintf(stderr, "%s: no connected output\n", drm_device);
+        ImGui_ImplKms_DestroyDisplay();
+        return false;
+    }
+
+    bd->GbmDevice = gbm_create_device(bd->DrmFd);
+    bd->GbmSurface = bd->GbmDevice ? gbm_surface_create(bd->GbmDevice, bd->Mode.hdisplay, bd->Mode.vdisplay, GBM_FORMAT_XRGB8888, GBM_BO_USE_SCANOUT | GBM_BO_USE_RENDERING) : nullptr;
+    if (!bd->GbmSurface)
+    {
+        fprintf(stderr, "%s: can't create a GBM scanout surface\n", drm_device);
+        ImGui_ImplKms_DestroyDisplay();
+        return false;
+    }
+    if (!ImGui_ImplKms_CreateEglContext(bd))
+    {
+        fprintf(stderr, "%s: EGL setup failed (0x%04x)\n", drm_device, eglGetError());
+        ImGui_ImplKms_DestroyDisplay();
+        return false;
+    }
+
+    bd->EventContext.version = 2;
+    bd->EventContext.page_flip_handler = ImGui_ImplKms_PageFlipHandler;
+    bd->WakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    printf("KMS: %s %dx%d@%d on connector %u, CRTC %u\n", drm_device, bd->Mode.hdisplay, bd->Mode.vdisplay, bd->Mode.vrefresh, bd->ConnectorId, bd->CrtcId);
+    return true;
+}
+
+void    ImGui_ImplKms_DestroyDisplay()
+{
+    ImGui_ImplKms_Data* bd = &g_Kms;
+    if (bd->DrmFd == 0)
+        return;
+
+    // Put the previous framebuffer (usually the console) back before ours go away
+    if (bd->SavedCrtc)
+    {
+        if (bd->ModeSet)
+            drmModeSetCrtc(bd->DrmFd, bd->SavedCrtc->crtc_id, bd->SavedCrtc->buffer_id, bd->SavedCrtc->x, bd->SavedCrtc->y, &bd->ConnectorId, 1, &bd->SavedCrtc->mode);
+        drmModeFreeCrtc(bd->SavedCrtc);
+    }
+
+    if (bd->EglDisplay != EGL_NO_DISPLAY)
+    {
+        eglMakeCurrent(bd->EglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (bd->EglSurface != EGL_NO_SURFACE)
+            eglDestroySurface(bd->EglDisplay, bd->EglSurface);
+        if (bd->EglContext != EGL_NO_CONTEXT)
+            eglDestroyContext(bd->EglDisplay, bd->EglContext);
+        eglTerminate(bd->EglDisplay);
+    }
+    if (bd->ScanoutBo)
+        gbm_surface_release_buffer(bd->GbmSurface, bd->ScanoutBo);
+    if (bd->GbmSurface)
+        gbm_surface_destroy(bd->GbmSurface);
+    if (bd->GbmDevice)
+        gbm_device_destroy(bd->GbmDevice);
+    if (bd->WakeFd >= 0)
+        close(bd->WakeFd);
+    close(bd->DrmFd);
+    memset((void*)bd, 0, sizeof(*bd));
+}
+
+void    ImGui_ImplKms_GetDisplaySize(int* width, int* height)
+{
+    *width = g_Kms.Mode.hdisplay;
+    *height = g_Kms.Mode.vdisplay;
+}
+
+static void ImGui_ImplKms_DestroyFramebuffer(gbm_bo* bo, void* user_data)
+{
+    drmModeRmFB(gbm_device_get_fd(gbm_bo_get_device(bo)), (uint32_t)(uintptr_t)user_data);
+}
+
+// GBM cycles through a few buffers, each gets a DRM framebuffer the first time we see it
+static uint32_t ImGui_ImplKms_FramebufferForBo(ImGui_ImplKms_Data* bd, gbm_bo* bo)
+{
+    uint32_t fb_id = (uint32_t)(uintptr_t)gbm_bo_get_user_data(bo);
+    if (fb_id)
+        return fb_id;
+
+    uint32_t handles[4] = { gbm_bo_get_handle(bo).u32 };
+    uint32_t strides[4] = { gbm_bo_get_stride(bo) };
+    uint32_t offsets[4] = { 0 };
+    if (drmModeAddFB2(bd->DrmFd, gbm_bo_get_width(bo), gbm_bo_get_height(bo), gbm_bo_get_format(bo), handles, strides, offsets, &fb_id, 0) != 0)
+    {
+        perror("drmModeAddFB2");
+        return 0;
+    }
+    gbm_bo_set_user_data(bo, (void*)(uintptr_t)fb_id, ImGui_ImplKms_DestroyFramebuffer);
+    return fb_id;
+}
+
+// Vsync: the flip event arrives at the vblank the new buffer went on screen
+static bool ImGui_ImplKms_WaitForFlip(ImGui_ImplKms_Data* bd)
+{
+    while (bd->FlipPending)
+    {
+        struct pollfd drm_poll = { bd->DrmFd, POLLIN, 0 };
+        if (poll(&drm_poll, 1, -1) < 0 && errno != EINTR)
+        {
+            perror("poll");
+            return false;
+        }
+        if (drm_poll.revents & POLLIN)
+            drmHandleEvent(bd->DrmFd, &bd->EventContext);
+    }
+    return true;
+}
+
+bool    ImGui_ImplKms_SwapBuffers()
+{
+    ImGui_ImplKms_Data* bd = &g_Kms;
+    if (!eglSwapBuffers(bd->EglDisplay, bd->EglSurface))
+        return false;
+    gbm_bo* bo = gbm_surface_lock_front_buffer(bd->GbmSurface);
+    if (!bo)
+        return false;
+    uint32_t fb_id = ImGui_ImplKms_FramebufferForBo(bd, bo);
+    if (!fb_id)
+    {
+        gbm_surface_release_buffer(bd->GbmSurface, bo);
+        return false;
+    }
+
+    if (!bd->ModeSet)
+    {
+        // First frame: mode set straight onto it, this is the moment the dash appears
+        if (drmModeSetCrtc(bd->DrmFd, bd->CrtcId, fb_id, 0, 0, &bd->ConnectorId, 1, &bd->Mode) != 0)
+        {
+            perror("drmModeSetCrtc");
+            gbm_surface_release_buffer(bd->GbmSurface, bo);
+            return false;
+        }
+        bd->ModeSet = true;
+    }
+    else
+    {
+        // A flip left queued by a failed wait last time has to land before the next one
+        if (!ImGui_ImplKms_WaitForFlip(bd))
+        {
+            gbm_surface_release_buffer(bd->GbmSurface, bo);
+            return false;
+        }
+        bd->FlipPending = true;
+        if (drmModePageFlip(bd->DrmFd, bd->CrtcId, fb_id, DRM_MODE_PAGE_FLIP_EVENT, bd) != 0)
+        {
+            perror("drmModePageFlip");
+            bd->FlipPending = false;
+            gbm_surface_release_buffer(bd->GbmSurface, bo);
+            return false;
+        }
+        if (!ImGui_ImplKms_WaitForFlip(bd))
+        {
+            // The flip is still queued and bo goes on screen with it, so it is the scanout
+            // buffer now; FlipPending stays set until its event is handled
+            if (bd->ScanoutBo)
+                gbm_surface_release_buffer(bd->GbmSurface, bd->ScanoutBo);
+            bd->ScanoutBo = bo;
+            return false;
+        }
+    }
+
+    if (bd->ScanoutBo)
+        gbm_surface_release_buffer(bd->GbmSurface, bd->ScanoutBo);
+    bd->ScanoutBo = bo;
+    return true;
+}
+
+void    ImGui_ImplKms_PostEmptyEvent()
+{
+    uint64_t one = 1;
+    if (write(g_Kms.WakeFd, &one, sizeof(one)) < 0)
+    {
+        // Counter full, the render thread is already due to wake
+    }
+}
+
+uint64_t ImGui_ImplKms_ConsumeInputTimestamp()
+{
+    uint64_t timestamp = g_Kms.PendingInputNs;
+    g_Kms.PendingInputNs = 0;
+    return timestamp;
+}
+
+static ImGuiKey ImGui_ImplKms_KeyToImGuiKey(unsigned int code)
+{
+    switch (code)
+    {
+        case KEY_TAB: return ImGuiKey_Tab;
+        case KEY_LEFT: return ImGuiKey_LeftArrow;
+        case KEY_RIGHT: return ImGuiKey_RightArrow;
+        case KEY_UP: return ImGuiKey_UpArrow;
+        case KEY_DOWN: return ImGuiKey_DownArrow;
+        case KEY_PAGEUP: return ImGuiKey_PageUp;
+        case KEY_PAGEDOWN: return ImGuiKey_PageDown;
+        case KEY_HOME: return ImGuiKey_Home;
+        case KEY_END: return ImGuiKey_End;
+        case KEY_INSERT: return ImGuiKey_Insert;
+        case KEY_DELETE: return ImGuiKey_Delete;
+        case KEY_BACKSPACE: return ImGuiKey_Backspace;
+        case KEY_SPACE: return ImGuiKey_Space;
+        case KEY_ENTER: return ImGuiKey_Enter;
+        case KEY_ESC: return ImGuiKey_Escape;
+        case KEY_LEFTCTRL: return ImGuiKey_LeftCtrl;
+        case KEY_LEFTSHIFT: return ImGuiKey_LeftShift;
+        case KEY_LEFTALT: return ImGuiKey_LeftAlt;
+        case KEY_LEFTMETA: return ImGuiKey_LeftSuper;
+        case KEY_RIGHTCTRL: return ImGuiKey_RightCtrl;
+        case KEY_RIGHTSHIFT: return ImGuiKey_RightShift;
+        case KEY_RIGHTALT: return ImGuiKey_RightAlt;
+        case KEY_RIGHTMETA: return ImGuiKey_RightSuper;
+        case KEY_0: return ImGuiKey_0;
+        case KEY_1: return ImGuiKey_1;
+        case KEY_2: return ImGuiKey_2;
+        case KEY_3: return ImGuiKey_3;
+        case KEY_4: return ImGuiKey_4;
+        case KEY_5: return ImGuiKey_5;
+        case KEY_6: return ImGuiKey_6;
+        case KEY_7: return ImGuiKey_7;
+        case KEY_8: return ImGuiKey_8;
+        case KEY_9: return ImGuiKey_9;
+        case KEY_A: return ImGuiKey_A;
+        case KEY_B: return ImGuiKey_B;
+        case KEY_C: return ImGuiKey_C;
+        case KEY_D: return ImGuiKey_D;
+        case KEY_E: return ImGuiKey_E;
+        case KEY_F: return ImGuiKey_F;
+        case KEY_G: return ImGuiKey_G;
+        case KEY_H: return ImGuiKey_H;
+        case KEY_I: return ImGuiKey_I;
+        case KEY_J: return ImGuiKey_J;
+        case KEY_K: return ImGuiKey_K;
+        case KEY_L: return ImGuiKey_L;
+        case KEY_M: return ImGuiKey_M;
+        case KEY_N: return ImGuiKey_N;
+        case KEY_O: return ImGuiKey_O;
+        case KEY_P: return ImGuiKey_P;
+        case KEY_Q: return ImGuiKey_Q;
+        case KEY_R: return ImGuiKey_R;
+        case KEY_S: return ImGuiKey_S;
+        case KEY_T: return ImGuiKey_T;
+        case KEY_U: return ImGuiKey_U;
+        case KEY_V: return ImGuiKey_V;
+        case KEY_W: return ImGuiKey_W;
+        case KEY_X: return ImGuiKey_X;
+        case KEY_Y: return ImGuiKey_Y;
+        case KEY_Z: return ImGuiKey_Z;
+        case KEY_F1: return ImGuiKey_F1;
+        case KEY_F2: return ImGuiKey_F2;
+        case KEY_F3: return ImGuiKey_F3;
+        case KEY_F4: return ImGuiKey_F4;
+        case KEY_F5: return ImGuiKey_F5;
+        case KEY_F6: return ImGuiKey_F6;
+        case KEY_F7: return ImGuiKey_F7;
+        case KEY_F8: return ImGuiKey_F8;
+        case KEY_F9: return ImGuiKey_F9;
+        case KEY_F10: return ImGuiKey_F10;
+        case KEY_F11: return ImGuiKey_F11;
+        case KEY_F12: return ImGuiKey_F12;
+        default: return ImGuiKey_None;
+    }
+}
+
+static void ImGui_ImplKms_ProcessKey(ImGui_ImplKms_Data* bd, const struct input_event& event)
+{
+    if (event.value == 2)
+        return; // Autorepeat, ImGui does its own
+    bool down = event.value != 0;
+    if (bd->PendingInputNs == 0)
+        bd->PendingInputNs = (uint64_t)event.time.tv_sec * 1000000000ull + (uint64_t)event.time.tv_usec * 1000ull;
+
+    ImGuiIO& io = ImGui::GetIO();
+    static const unsigned short modifier_keys[8] = { KEY_LEFTCTRL, KEY_RIGHTCTRL, KEY_LEFTSHIFT, KEY_RIGHTSHIFT, KEY_LEFTALT, KEY_RIGHTALT, KEY_LEFTMETA, KEY_RIGHTMETA };
+    static const ImGuiKey modifiers[4] = { ImGuiMod_Ctrl, ImGuiMod_Shift, ImGuiMod_Alt, ImGuiMod_Super };
+    for (int i = 0; i < 8; i++)
+        if (event.code == modifier_keys[i])
+        {
+            bd->ModifierDown[i] = down;
+            io.AddKeyEvent(modifiers[i / 2], bd->ModifierDown[i & ~1] || bd->ModifierDown[i | 1]);
+        }
+
+    ImGuiKey key = ImGui_ImplKms_KeyToImGuiKey(event.code);
+    if (key != ImGuiKey_None)
+        io.AddKeyEvent(key, down);
+}
+
+void    ImGui_ImplKms_WaitEvents(double timeout_seconds)
+{
+    ImGui_ImplKms_Data* bd = &g_Kms;
+    struct pollfd fds[1 + KMS_MAX_KEYBOARDS];
+    int fd_count = 0;
+    fds[fd_count++] = { bd->WakeFd, POLLIN, 0 };
+    for (int i = 0; i < bd->KeyboardCount; i++)
+        fds[fd_count++] = { bd->KeyboardFds[i], POLLIN, 0 };
+
+    int timeout_ms = timeout_seconds > 0.0 ? (int)ceil(timeout_seconds * 1000.0) : 0;
+    if (poll(fds, fd_count, timeout_ms) <= 0)
+        return; // Timeout, or a signal (SIGTERM) the caller checks for
+
+    if (fds[0].revents & POLLIN)
+    {
+        uint64_t count;
+        if (read(bd->WakeFd, &count, sizeof(count)) < 0)
+        {
+            // Already drained
+        }
+    }
+    for (int i = 1; i < fd_count; i++)
+    {
+        if (!(fds[i].revents & POLLIN))
+            continue;
+        struct input_event events[32];
+        ssize_t length;
+        while ((length = read(fds[i].fd, events, sizeof(events))) > 0)
+            for (size_t e = 0; e < (size_t)length / sizeof(events[0]); e++)
+                if (events[e].type == EV_KEY)
+                    ImGui_ImplKms_ProcessKey(bd, events[e]);
+    }
+}
+
+bool    ImGui_ImplKms_Init()
+{
+    ImGuiIO& io = ImGui::GetIO();
+    IM_ASSERT(io.BackendPlatformUserData == nullptr && "Already initialized a platform backend!");
+    IM_ASSERT(g_Kms.DrmFd != 0 && "Call ImGui_ImplKms_CreateDisplay() first");
+
+    ImGui_ImplKms_Data* bd = &g_Kms;
+    io.BackendPlatformUserData = (void*)bd;
+    io.BackendPlatformName = "imgui_impl_kms";
+
+    // Anything with a space bar counts as a keyboard
+    for (int i = 0; i < 32 && bd->KeyboardCount < KMS_MAX_KEYBOARDS; i++)
+    {
+        char path[32];
+        snprintf(path, sizeof(path), "/dev/input/event%d", i);
+        int fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0)
+            continue;
+        unsigned long keys[KEY_MAX / (8 * sizeof(unsigned long)) + 1] = {};
+        const size_t bits_per_word = 8 * sizeof(unsigned long);
+        if (ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keys)), keys) >= 0 && (keys[KEY_SPACE / bits_per_word] & (1ul << (KEY_SPACE % bits_per_word))))
+            bd->KeyboardFds[bd->KeyboardCount++] = fd;
+        else
+            close(fd);
+    }
+    if (bd->KeyboardCount == 0)
+        fprintf(stderr, "KMS: no readable keyboards in /dev/input (is the user in the input group?)\n");
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    bd->Time = now.tv_sec + now.tv_nsec / 1e9;
+    return true;
+}
+
+void    ImGui_ImplKms_Shutdown()
+{
+    ImGui_ImplKms_Data* bd = &g_Kms;
+    ImGuiIO& io = ImGui::GetIO();
+    IM_ASSERT(io.BackendPlatformUserData != nullptr && "No platform backend to shutdown, or already shutdown?");
+
+    for (int i = 0; i < bd->KeyboardCount; i++)
+        close(bd->KeyboardFds[i]);
+    bd->KeyboardCount = 0;
+    io.BackendPlatformName = nullptr;
+    io.BackendPlatformUserData = nullptr;
+}
+
+void    ImGui_ImplKms_NewFrame()
+{
+    ImGui_ImplKms_Data* bd = &g_Kms;
+    IM_ASSERT(bd->DrmFd != 0 && "Did you call ImGui_ImplKms_Init()?");
+    ImGuiIO& io = ImGui::GetIO();
+
+    io.DisplaySize = ImVec2((float)bd->Mode.hdisplay, (float)bd->Mode.vdisplay);
+    io.DisplayFramebufferScale = ImVec2(1.0f, 1.0f);
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double current_time = now.tv_sec + now.tv_nsec / 1e9;
+    io.DeltaTime = current_time > bd->Time ? (float)(current_time - bd->Time) : (float)(1.0f / 60.0f);
+    bd->Time = current_time;
+}
+
+//-----------------------------------------------------------------------------
+
+#endif // #ifndef IMGUI_DISABLE
@@ -0,0 +1,41 @@
+// dear imgui: Platform Backend for direct DRM/KMS output (GBM + EGL, evdev keyboards), no X11/Wayland
+// This needs to be used along with a Renderer Backend (e.g. OpenGL2, GLES2)
+
+// Implemented features:
+//  [X] Platform: Keyboard support from every /dev/input/event* device with keys, with kernel event timestamps.
+//  [X] Platform: Page flipped, vsynced presentation; SwapBuffers() returns once the new frame is on screen.
+//  [ ] Platform: Mouse/touch input, text input, gamepads, hotplug of displays or keyboards.
+
+// The display half (CreateDisplay..PostEmptyEvent) works without an ImGui context, the way GLFW's window does,
+// so it can be brought up first. Only one display per process.
+//
+// Needs DRM master, i.e. no X server or compositor on the same card, read access to /dev/input/event* (input group)
+// and libdrm, libgbm and libEGL. The context is desktop GL, or GLES2 when built with IMGUI_IMPL_OPENGL_ES2.
+
+#pragma once
+#include "imgui.h"      // IMGUI_IMPL_API
+#ifndef IMGUI_DISABLE
+#include <stdint.h>
+
+// Mode sets the first connected output on drm_device (e.g. "/dev/dri/card0") at its preferred mode and makes an EGL
+// context on it current. The mode set itself happens at the first SwapBuffers(), so nothing flashes before a frame exists.
+IMGUI_IMPL_API bool     ImGui_ImplKms_CreateDisplay(const char* drm_device);
+IMGUI_IMPL_API void     ImGui_ImplKms_DestroyDisplay();
+IMGUI_IMPL_API void     ImGui_ImplKms_GetDisplaySize(int* width, int* height);
+
+// eglSwapBuffers() then a page flip, waiting for the flip event. Returns false if the frame couldn't be shown.
+IMGUI_IMPL_API bool     ImGui_ImplKms_SwapBuffers();
+
+// Handles input until some arrives, PostEmptyEvent() is called or timeout_seconds passes. 0 only polls.
+IMGUI_IMPL_API void     ImGui_ImplKms_WaitEvents(double timeout_seconds);
+IMGUI_IMPL_API void     ImGui_ImplKms_PostEmptyEvent();     // Safe from any thread
+
+// Kernel timestamp (CLOCK_REALTIME ns) of the first key event handled since the last call, 0 if none.
+// Read after SwapBuffers() to measure input-to-display latency.
+IMGUI_IMPL_API uint64_t ImGui_ImplKms_ConsumeInputTimestamp();
+
+IMGUI_IMPL_API bool     ImGui_ImplKms_Init();
+IMGUI_IMPL_API void     ImGui_ImplKms_Shutdown();
+IMGUI_IMPL_API void     ImGui_ImplKms_NewFrame();
+
+#endif // #ifndef IMGUI_DISABLE
@@ -0,0 +1,168 @@
+// Receive throughput of SocketCanSource on a vcan interface flooded by a local generator,
+// one recvmsg() per frame (config.batchedRead = false) against recvmmsg() batches.
+// Reports frames/s received, frames dropped by the kernel and the receiving thread's CPU.
+//
+//   sudo ip link add dev vcan0 type vcan && sudo ip link set up vcan0
+//   bench/can_read_bench [interface] [seconds] [generator rate Hz, 0 = flat out]
+//
+// Runs flat out and at a full 1 Mbit/s bus (~8000 frames/s) unless a rate is given.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "config.h"
+#include "socketcan_source.h"
+#include "timestamp.h"
+
+Config config;
+
+static int openSender(const char* ifname)
+{
+    int s = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+    if (s < 0)
+        return -1;
+
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    snprintf(ifr.ifr_name, sizeof(ifr.ifr_name), "%s", ifname);
+    struct sockaddr_can addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.can_family = AF_CAN;
+    if (ioctl(s, SIOCGIFINDEX, &ifr) < 0)
+    {
+        close(s);
+        return -1;
+    }
+    addr.can_ifindex = ifr.ifr_ifindex;
+    if (bind(s, (struct sockaddr*)&addr, sizeof(addr)) < 0)
+    {
+        close(s);
+        return -1;
+    }
+    return s;
+}
+
+// Civic IDs round robin, rateHz frames per second on an absolute schedule (0 = as fast as vcan takes them)
+static void generate(int s, double rateHz, double seconds, std::atomic<uint64_t>& sent)
+{
+    static const canid_t ids[] = { 660, 661, 662, 664, 667 };
+    struct can_frame frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.can_dlc = 8;
+
+    uint64_t start = realtimeNs();
+    uint64_t end = start + static_cast<uint64_t>(seconds * 1e9);
+    for (uint64_t n = 0;; n++)
+    {
+        uint64_t now = realtimeNs();
+        if (now >= end)
+            break;
+        if (rateHz > 0)
+        {
+            uint64_t due = start + static_cast<uint64_t>(n * 1e9 / rateHz);
+            if (due > now)
+            {
+                struct timespec wait = { static_cast<time_t>((due - now) / 1000000000ull), static_cast<long>((due - now) % 1000000000ull) };
+                nanosleep(&wait, nullptr);
+            }
+        }
+
+        frame.can_id = ids[n % (sizeof(ids) / sizeof(ids[0]))];
+        memcpy(frame.data, &n, sizeof(n));
+        if (write(s, &frame, sizeof(frame)) == sizeof(frame))
+            sent.fetch_add(1, std::memory_order_relaxed);
+        else
+            n--; // vcan's queue is full (ENOBUFS), try again
+    }
+}
+
+static double threadCpuSeconds()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_THREAD, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+static bool run(const char* ifname, bool batched, double rateHz, double seconds)
+{
+    config.batchedRead = batched;
+    SocketCanSource source;
+    if (!source.open(ifname, {}))
+        return false;
+    int sender = openSender(ifname);
+    if (sender < 0)
+    {
+        perror(ifname);
+        return false;
+    }
+
+    std::atomic<bool> running(true);
+    uint64_t received = 0, calls = 0;
+    double cpuSeconds = 0.0;
+    std::thread receiver([&]() {
+        FrameBatch batch;
+        double cpuStart = threadCpuSeconds();
+        while (running.load(std::memory_order_relaxed))
+        {
+            int count = source.receive(batch);
+            if (count < 0)
+                break;
+            received += count;
+            calls += count > 0;
+        }
+        cpuSeconds = threadCpuSeconds() - cpuStart;
+    });
+
+    std::atomic<uint64_t> sent(0);
+    uint64_t start = realtimeNs();
+    generate(sender, rateHz, seconds, sent);
+    usleep(100000); // Let the receiver drain what's queued
+    double elapsed = (realtimeNs() - start) / 1e9;
+    running = false;
+    source.interrupt();
+    receiver.join();
+    close(sender);
+
+    char rate[32];
+    snprintf(rate, sizeof(rate), rateHz > 0 ? "%.0f Hz" : "flat out", rateHz);
+    printf("%-8s %-9s sent %9.0f/s  received %9.0f/s  dropped %5.2f%%  %5.1f frames/call  CPU %5.1f%%\n",
+           batched ? "recvmmsg" : "recvmsg", rate, sent / elapsed, received / elapsed,
+           sent ? 100.0 * (sent - std::min<uint64_t>(received, sent)) / sent : 0.0,
+           calls ? (double)received / calls : 0.0, 100.0 * cpuSeconds / elapsed);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    const char* ifname = argc > 1 ? argv[1] : "vcan0";
+    double seconds = argc > 2 ? atof(argv[2]) : 3.0;
+    if (if_nametoindex(ifname) == 0)
+    {
+        fprintf(stderr, "No interface %s, create one with:\n  sudo ip link add dev %s type vcan && sudo ip link set up %s\n", ifname, ifname, ifname);
+        return 1;
+    }
+
+    const double busRateHz = 8000.0;
+    double rates[2] = { 0.0, busRateHz };
+    int rateCount = 2;
+    if (argc > 3)
+    {
+        rates[0] = atof(argv[3]);
+        rateCount = 1;
+    }
+
+    for (int r = 0; r < rateCount; r++)
+        for (bool batched : { false, true })
+            if (!run(ifname, batched, rates[r], seconds))
+                return 1;
+    return 0;
+}
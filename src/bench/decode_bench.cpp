@@ -0,0 +1,327 @@
+// ns/frame to decode a Civic stream, the switch readCanData used to run against the
+// decoders it was replaced with. The stream is ~200k frames of the Civic IDs at their
+// relative rates plus 10% traffic from other IDs, with plausible random payloads;
+// each decoder runs over it several times and the best pass is reported.
+// DbcDecoder is compared with the profile on a second stream of the 1632-1634 messages
+// assets/civic.dbc defines, so both decode the same eight signals. Last, the CAN thread's
+// batch decode (SIMD word extraction) runs against decoding the same batches a frame at
+// a time with the scalar decodeSignal, on a recorded log if one is given, and every
+// batch's results are compared bit for bit.
+//
+//   bench/decode_bench [frames] [dbc file] [recorded candump/ASC/session log]
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "can_decoder.h"
+#include "dbc_decoder.h"
+#include "replay_source.h"
+
+Config config;
+ThermistorTable thermistorTable;
+ChannelScales channelScales;
+
+#define PASSES 10
+
+static std::vector<struct can_frame> civicStream(size_t count)
+{
+    // Relative rates: engine data fastest, temperatures slowest
+    static const canid_t ids[] = { 660, 660, 660, 660, 661, 662, 662, 662, 664, 664, 667 };
+    static const canid_t otherIds[] = { 0x0C8, 0x1A0, 0x2F0, 0x4B0, 0x7E8 };
+    std::mt19937 rng(660);
+    std::vector<struct can_frame> frames(count);
+    for (struct can_frame& frame : frames)
+    {
+        frame = {};
+        frame.can_dlc = 8;
+        bool other = rng() % 10 == 0;
+        frame.can_id = other ? otherIds[rng() % 5] : ids[rng() % (sizeof(ids) / sizeof(ids[0]))];
+        for (uint8_t& byte : frame.data)
+            byte = static_cast<uint8_t>(rng());
+        if (frame.can_id == 664 || frame.can_id == 667)
+        {
+            // Lambda and thermistor raw values are never 0 on a running car
+            uint16_t raw = 200 + rng() % 30000;
+            frame.data[0] = raw >> 8;
+            frame.data[1] = raw & 0xFF;
+        }
+    }
+    return frames;
+}
+
+// The same stream on the IDs civic.dbc covers, engine data on 1632-1634 and the rest other traffic
+static std::vector<struct can_frame> civicDbcStream(size_t count)
+{
+    std::vector<struct can_frame> frames = civicStream(count);
+    for (struct can_frame& frame : frames)
+    {
+        if (frame.can_id >= 660 && frame.can_id <= 662)
+            frame.can_id += 1632 - 660;
+        else if (frame.can_id == 664 || frame.can_id == 667)
+            frame.can_id = 0x4B0;
+    }
+    return frames;
+}
+
+// ------------------ The decoder readCanData had before the tables ------------------
+// With the per-channel receive times decodeFrame stores added, so both do the same work
+struct LegacyCanData
+{
+    float rpm = 0.0;
+    int speed = 0;
+    int gear = 0;
+    float voltage = 0.0;
+    int iat = 0;
+    int ect = 0;
+    int tps = 0;
+    int map = 0;
+    float lambdaRatio = 0.0;
+    double oilTemp = 0.0;
+    double oilPressure = 0.0;
+    uint64_t timestampNs[CH_COUNT] = {};
+};
+
+struct LegacyConfig
+{
+    bool civic = true;
+    bool mazda = false;
+};
+static LegacyConfig legacyConfig;
+
+template <bool ThermistorTableLookup>
+static inline void legacyDecode(const struct can_frame& frame, uint64_t timestampNs, LegacyCanData& canData)
+{
+    if (legacyConfig.civic)
+    {
+        switch (frame.can_id)
+        {
+            case 660:
+            case 1632:
+                canData.rpm = static_cast<float>(concatenateBytes(frame.data[0], frame.data[1]));
+                canData.speed = concatenateBytes(frame.data[2], frame.data[3]);
+                canData.gear = frame.data[4];
+                canData.voltage = static_cast<float>(frame.data[5]) / 10;
+                canData.timestampNs[CH_RPM] = canData.timestampNs[CH_SPEED] = timestampNs;
+                canData.timestampNs[CH_GEAR] = canData.timestampNs[CH_VOLTAGE] = timestampNs;
+                break;
+            case 661:
+            case 1633:
+                canData.iat = concatenateBytes(frame.data[0], frame.data[1]);
+                canData.ect = concatenateBytes(frame.data[2], frame.data[3]);
+                canData.timestampNs[CH_IAT] = canData.timestampNs[CH_ECT] = timestampNs;
+                break;
+            case 662:
+            case 1634:
+                canData.tps = concatenateBytes(frame.data[0], frame.data[1]);
+                canData.map = concatenateBytes(frame.data[2], frame.data[3]) / 10;
+                canData.timestampNs[CH_TPS] = canData.timestampNs[CH_MAP] = timestampNs;
+                break;
+            case 664:
+            case 1636:
+                canData.lambdaRatio = 32768.0f / static_cast<float>(concatenateBytes(frame.data[0], frame.data[1]));
+                canData.timestampNs[CH_LAMBDA] = timestampNs;
+                break;
+            case 667:
+            case 1639:
+                if (ThermistorTableLookup)
+                    canData.oilTemp = thermistorTable.lookup(concatenateBytes(frame.data[0], frame.data[1]));
+                else
+                {
+                    double oilTempResistance = concatenateBytes(frame.data[0], frame.data[1]);
+                    double kelvinTemp = 1.0 / (config.conA + config.conB * log(oilTempResistance) + config.conC * pow(log(oilTempResistance), 3));
+                    canData.oilTemp = kelvinTemp - 273.15;
+                }
+                {
+                    double oilPressureResistance = concatenateBytes(frame.data[2], frame.data[3]);
+                    double ratio = (oilPressureResistance - config.originalLow) / (config.originalHigh - config.originalLow);
+                    double kPaValue = (ratio * (config.desiredHigh - config.desiredLow)) + config.desiredLow;
+                    canData.oilPressure = (kPaValue * 0.145038);
+                }
+                canData.timestampNs[CH_OIL_TEMP] = canData.timestampNs[CH_OIL_PRESSURE] = timestampNs;
+                break;
+        }
+
+        if (canData.tps == 65535)
+            canData.tps = 0;
+    }
+
+    if (legacyConfig.mazda)
+    {
+        switch (frame.can_id)
+        {
+            case 201:
+            case 513:
+                canData.rpm = ((256 * frame.data[0]) + frame.data[1]) / 4;
+                canData.tps = frame.data[6] / 2;
+                canData.timestampNs[CH_RPM] = canData.timestampNs[CH_TPS] = timestampNs;
+                break;
+        }
+    }
+}
+// -----------------------------------------------------------------------------------
+
+// Keeps the compiler from merging or dropping the stores of a decode it can't see used
+template <typename T>
+static inline void escape(T& data)
+{
+    asm volatile("" : : "r"(&data) : "memory");
+}
+
+// Best of PASSES over frames, in ns per frame
+template <typename Decode>
+static double timeDecoder(const std::vector<struct can_frame>& frames, Decode decode)
+{
+    double best = 1e30;
+    for (int pass = 0; pass < PASSES; pass++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        decode();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        if (ns < best)
+            best = ns;
+    }
+    return best / frames.size();
+}
+
+int main(int argc, char** argv)
+{
+    size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 200000;
+    std::vector<struct can_frame> frames = civicStream(count);
+    thermistorTable.build(config.conA, config.conB, config.conC);
+
+    LegacyCanData legacyData;
+    CANBusData canData;
+
+    double legacyNs = timeDecoder(frames, [&]() {
+        uint64_t timestampNs = 0;
+        for (const struct can_frame& frame : frames)
+        {
+            legacyDecode<false>(frame, ++timestampNs, legacyData);
+            escape(legacyData);
+        }
+    });
+    double legacyLookupNs = timeDecoder(frames, [&]() {
+        uint64_t timestampNs = 0;
+        for (const struct can_frame& frame : frames)
+        {
+            legacyDecode<true>(frame, ++timestampNs, legacyData);
+            escape(legacyData);
+        }
+    });
+    double dispatchNs = timeDecoder(frames, [&]() {
+        uint64_t timestampNs = 0;
+        for (const struct can_frame& frame : frames)
+        {
+            decodeFrame<CivicProfile>(frame, ++timestampNs, canData);
+            escape(canData);
+        }
+    });
+
+    printf("%zu frames, best of %d passes\n", frames.size(), PASSES);
+    printf("%-44s %6.2f ns/frame\n", "switch, log/pow oil temp (original)", legacyNs);
+    printf("%-44s %6.2f ns/frame\n", "switch, table oil temp", legacyLookupNs);
+    printf("%-44s %6.2f ns/frame\n", "decodeFrame<CivicProfile> (unrolled rows)", dispatchNs);
+
+    // Profile against the DBC decoder built from the same messages
+    const char* dbcPath = argc > 2 ? argv[2] : "../assets/civic.dbc";
+    DbcDecoder dbcDecoder;
+    if (!dbcDecoder.load(dbcPath, nullptr))
+        return 1;
+    ProfileDecoder<CivicProfile> profileDecoder;
+    std::vector<struct can_frame> dbcFrames = civicDbcStream(count);
+
+    double profileNs = timeDecoder(dbcFrames, [&]() {
+        uint64_t timestampNs = 0;
+        for (const struct can_frame& frame : dbcFrames)
+        {
+            profileDecoder.decode(frame.can_id, frame.data, ++timestampNs, canData, nullptr);
+            escape(canData);
+        }
+    });
+    double dbcNs = timeDecoder(dbcFrames, [&]() {
+        uint64_t timestampNs = 0;
+        for (const struct can_frame& frame : dbcFrames)
+        {
+            dbcDecoder.decode(frame.can_id, frame.data, ++timestampNs, canData, nullptr);
+            escape(canData);
+        }
+    });
+
+    printf("%-44s %6.2f ns/frame\n", "ProfileDecoder<CivicProfile>, 1632-1634", profileNs);
+    printf("%-44s %6.2f ns/frame\n", "DbcDecoder (civic.dbc), 1632-1634", dbcNs);
+
+    // Scalar against SIMD over the batches the CAN thread would get
+    std::vector<FrameBatch> batches;
+    std::vector<int> batchCounts;
+    const char* recordedPath = argc > 3 ? argv[3] : nullptr;
+    if (recordedPath)
+    {
+        ReplaySource replay;
+        if (!replay.open(recordedPath))
+            return 1;
+        replay.setSpeed(0.0);
+        for (;;)
+        {
+            batches.emplace_back();
+            int got = replay.receive(batches.back());
+            if (got <= 0)
+            {
+                batches.pop_back();
+                if (got < 0)
+                    break;
+                continue;
+            }
+            batchCounts.push_back(got);
+        }
+    } else {
+        for (size_t i = 0; i < frames.size(); i += CAN_BATCH_SIZE)
+        {
+            batches.emplace_back();
+            int got = static_cast<int>(std::min<size_t>(CAN_BATCH_SIZE, frames.size() - i));
+            memcpy(batches.back().frames, &frames[i], got * sizeof(struct can_frame));
+            memset(batches.back().timestamps, 0, sizeof(batches.back().timestamps));
+            batchCounts.push_back(got);
+        }
+    }
+    size_t batchFrames = 0;
+    for (int got : batchCounts)
+        batchFrames += got;
+
+    size_t mismatches = 0;
+    for (size_t b = 0; b < batches.size(); b++)
+    {
+        CANBusData scalarData, batchData;
+        for (int i = 0; i < batchCounts[b]; i++)
+            decodeFrame<CivicProfile>(batches[b].frames[i], batches[b].timestamps[i], scalarData);
+        decodeBatch<CivicProfile>(batches[b], batchCounts[b], batchData);
+        mismatches += memcmp(scalarData.values, batchData.values, sizeof(scalarData.values)) != 0;
+    }
+
+    std::vector<struct can_frame> batchFrameList(batchFrames); // Only its size is used, for ns/frame
+    double scalarNs = timeDecoder(batchFrameList, [&]() {
+        for (size_t b = 0; b < batches.size(); b++)
+        {
+            for (int i = 0; i < batchCounts[b]; i++)
+                decodeFrame<CivicProfile>(batches[b].frames[i], batches[b].timestamps[i], canData);
+            escape(canData);
+        }
+    });
+    double simdNs = timeDecoder(batchFrameList, [&]() {
+        for (size_t b = 0; b < batches.size(); b++)
+        {
+            decodeBatch<CivicProfile>(batches[b], batchCounts[b], canData);
+            escape(canData);
+        }
+    });
+
+    printf("%zu frames in %zu batches from %s\n", batchFrames, batches.size(), recordedPath ? recordedPath : "the generated stream");
+    printf("%-44s %6.2f ns/frame\n", "decodeFrame<CivicProfile>, scalar", scalarNs);
+    printf("%-44s %6.2f ns/frame\n", "decodeBatch<CivicProfile>, SIMD words", simdNs);
+    printf("%-44s %zu\n", "batches decoding differently", mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
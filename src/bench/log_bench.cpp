@@ -0,0 +1,146 @@
+// Session logger under load: a producer pushes frames at a fixed rate the way the CAN
+// thread does while the writer thread drains, writes and fdatasync()s them. Reports
+// records pushed, dropped and written, reads the file back to check every record made it
+// in order, and samples how far the file on disk trails the newest pushed frame (what a
+// power cut would lose; should stay under the flush interval plus a sync).
+//
+//   bench/log_bench [log file] [seconds] [rate Hz, 0 = flat out] [flush interval ms]
+//
+// Runs at a full 1 Mbit/s bus (~8000 frames/s), four such buses and flat out unless a
+// rate is given. Point it at the storage the dash logs to; /tmp may be a tmpfs.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "session_log_reader.h"
+#include "session_logger.h"
+#include "timestamp.h"
+
+Config config;
+ThermistorTable thermistorTable;
+ChannelScales channelScales;
+
+static void produce(SessionLogger& logger, double rateHz, double seconds, std::atomic<uint64_t>& pushed, std::atomic<uint64_t>& lastPushedNs)
+{
+    static const canid_t ids[] = { 660, 661, 662, 664, 667 };
+    struct can_frame frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.can_dlc = 8;
+
+    uint64_t start = realtimeNs();
+    uint64_t end = start + static_cast<uint64_t>(seconds * 1e9);
+    for (uint64_t n = 0;; n++)
+    {
+        uint64_t now = realtimeNs();
+        if (now >= end)
+            break;
+        if (rateHz > 0)
+        {
+            uint64_t due = start + static_cast<uint64_t>(n * 1e9 / rateHz);
+            if (due > now)
+            {
+                struct timespec wait = { static_cast<time_t>((due - now) / 1000000000ull), static_cast<long>((due - now) % 1000000000ull) };
+                nanosleep(&wait, nullptr);
+                now = realtimeNs();
+            }
+        }
+
+        // The payload carries the sequence number so the readback can check order
+        frame.can_id = ids[n % (sizeof(ids) / sizeof(ids[0]))];
+        memcpy(frame.data, &n, sizeof(n));
+        logger.push(frame, now);
+        pushed.store(n + 1, std::memory_order_relaxed);
+        lastPushedNs.store(now, std::memory_order_relaxed);
+    }
+}
+
+// Records read back in push order, stopping at the first out of place (gaps only where drops were counted)
+static uint64_t verify(const char* path, uint64_t expected, uint64_t dropped)
+{
+    SessionLogReader reader;
+    if (!reader.open(path))
+        return 0;
+
+    uint64_t count = 0, previous = 0;
+    SessionLogReader::Cursor cursor = reader.begin();
+    while (const LogRecord* record = cursor.next())
+    {
+        uint64_t n;
+        memcpy(&n, record->data, sizeof(n));
+        // Drops leave gaps, but never reorder
+        if ((count > 0 && n <= previous) || (dropped == 0 && n != count) || n >= expected)
+            return count;
+        previous = n;
+        count++;
+    }
+    return count;
+}
+
+static bool run(const char* path, double rateHz, double seconds, uint32_t flushIntervalMs)
+{
+    SessionLogger logger;
+    if (!logger.start(path, "civic", flushIntervalMs))
+        return false;
+
+    std::atomic<uint64_t> pushed(0), lastPushedNs(0);
+    uint64_t start = realtimeNs();
+    std::thread producer(produce, std::ref(logger), rateHz, seconds, std::ref(pushed), std::ref(lastPushedNs));
+
+    // Sample how far the file trails the producer, as a reader opening it after a crash would see it
+    double worstLagMs = 0.0;
+    while (realtimeNs() - start < static_cast<uint64_t>((seconds - 0.1) * 1e9))
+    {
+        usleep(100000);
+        uint64_t newest = lastPushedNs.load(std::memory_order_relaxed);
+        SessionLogReader reader;
+        if (newest && reader.open(path) && reader.blocks() > 0)
+            worstLagMs = std::max(worstLagMs, (double)(int64_t)(newest - reader.lastTimestampNs()) / 1e6);
+    }
+
+    producer.join();
+    double elapsed = (realtimeNs() - start) / 1e9;
+    logger.stop();
+
+    uint64_t total = pushed.load();
+    uint64_t dropped = logger.droppedRecords.load();
+    uint64_t written = logger.writtenRecords.load();
+    uint64_t readBack = verify(path, total, dropped);
+
+    char rate[32];
+    snprintf(rate, sizeof(rate), rateHz > 0 ? "%.0f Hz" : "flat out", rateHz);
+    printf("%-9s pushed %9.0f/s  dropped %llu  written %llu  read back %llu%s  %.2f MB/s  worst on-disk lag %.0f ms (flush %u ms)\n",
+           rate, total / elapsed, (unsigned long long)dropped, (unsigned long long)written, (unsigned long long)readBack,
+           readBack == written && written + dropped == total ? "" : " MISMATCH", logger.writtenBytes.load() / elapsed / (1024.0 * 1024.0),
+           worstLagMs, flushIntervalMs);
+
+    // Losing frames at a real bus rate is a failure; flat out only shows the headroom
+    return readBack == written && written + dropped == total && (rateHz == 0 || dropped == 0);
+}
+
+int main(int argc, char** argv)
+{
+    const char* path = argc > 1 ? argv[1] : "log_bench.wrdlog";
+    double seconds = argc > 2 ? atof(argv[2]) : 5.0;
+    uint32_t flushIntervalMs = argc > 4 ? atoi(argv[4]) : config.logFlushIntervalMs;
+
+    const double busRateHz = 8000.0;
+    double rates[3] = { busRateHz, 4 * busRateHz, 0.0 };
+    int rateCount = 3;
+    if (argc > 3)
+    {
+        rates[0] = atof(argv[3]);
+        rateCount = 1;
+    }
+
+    bool ok = true;
+    for (int r = 0; r < rateCount; r++)
+        ok = run(path, rates[r], seconds, flushIntervalMs) && ok;
+    remove(path);
+    return ok ? 0 : 1;
+}
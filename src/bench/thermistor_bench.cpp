@@ -0,0 +1,66 @@
+// Oil temp per reading: ThermistorTable::lookup() against computing Steinhart-Hart the
+// way readCanData used to (two log() and a pow() on doubles). Readings are random raw
+// values in a real sensor's range, so the table lookups miss cache as they would live.
+//
+//   bench/thermistor_bench [readings]
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "config.h"
+#include "thermistor.h"
+
+Config config;
+
+#define PASSES 10
+
+template <typename Convert>
+static double timeConversion(const std::vector<uint16_t>& readings, Convert convert)
+{
+    double best = 1e30;
+    double sink = 0.0;
+    for (int pass = 0; pass < PASSES; pass++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (uint16_t raw : readings)
+            sink += convert(raw);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        if (ns < best)
+            best = ns;
+    }
+    if (sink == 12345.678)
+        printf("%f\n", sink); // Keeps the results live
+    return best / readings.size();
+}
+
+int main(int argc, char** argv)
+{
+    size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+    std::mt19937 rng(667);
+    std::vector<uint16_t> readings(count);
+    for (uint16_t& raw : readings)
+        raw = 200 + rng() % 30000;
+
+    auto buildStart = std::chrono::steady_clock::now();
+    ThermistorTable table;
+    table.build(config.conA, config.conB, config.conC);
+    double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - buildStart).count();
+
+    double computeNs = timeConversion(readings, [](uint16_t raw) {
+        double oilTempResistance = raw;
+        double kelvinTemp = 1.0 / (config.conA + config.conB * log(oilTempResistance) + config.conC * pow(log(oilTempResistance), 3));
+        return kelvinTemp - 273.15;
+    });
+    double lookupNs = timeConversion(readings, [&](uint16_t raw) {
+        return static_cast<double>(table.lookup(raw));
+    });
+
+    printf("%zu readings, best of %d passes, table built in %.2f ms\n", count, PASSES, buildMs);
+    printf("%-32s %6.2f ns/reading\n", "log/pow (original)", computeNs);
+    printf("%-32s %6.2f ns/reading\n", "ThermistorTable::lookup()", lookupNs);
+    return 0;
+}
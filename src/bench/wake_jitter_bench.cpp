@@ -0,0 +1,136 @@
+// How late a thread blocked in epoll_wait() wakes after another thread signals it, the
+// way the CAN thread waits on its sockets, with the machine otherwise loaded by one
+// busy thread per CPU. Run with the CAN thread's default scheduling, then SCHED_FIFO,
+// then also pinned to the last CPU, then also with mlockall(), using the same
+// configureThread()/lockProcessMemory() the dash calls.
+//
+//   bench/wake_jitter_bench [seconds per run] [wakeups per second] [FIFO priority]
+//
+// FIFO and mlockall need root or CAP_SYS_NICE/CAP_IPC_LOCK; without them the runs fall
+// back to what was allowed, as printed.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "latency.h"
+#include "realtime.h"
+#include "timestamp.h"
+
+Config config;
+
+#define LOAD_BUFFER_BYTES (16 * 1024 * 1024) // Each load thread's working set, well past the caches
+
+// Keeps a CPU busy and the caches churned until running goes false
+static void load(std::atomic<bool>& running)
+{
+    std::vector<uint8_t> buffer(LOAD_BUFFER_BYTES);
+    size_t i = 0;
+    while (running.load(std::memory_order_relaxed))
+    {
+        buffer[i] += 1;
+        i = (i + 4099) % buffer.size();
+    }
+}
+
+static void run(const char* label, SchedulingPolicy policy, int priority, int cpu, bool lockMemory, double seconds, double rateHz)
+{
+    int wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+
+    if (lockMemory)
+        lockProcessMemory();
+
+    std::atomic<bool> running(true);
+    std::atomic<uint64_t> sentNs(0);
+    std::atomic<size_t> coalesced(0);
+    size_t expected = static_cast<size_t>(seconds * rateHz);
+    LatencyTracker wakeLatency(label, expected);
+
+    std::thread waiter([&]() {
+        while (running.load(std::memory_order_relaxed))
+        {
+            struct epoll_event ready;
+            if (epoll_wait(epollFd, &ready, 1, 100) <= 0)
+                continue;
+            // Stamp of the signal that woke us before our own clock read, so the later
+            // signal a slow read() can pick up never makes the latency negative
+            uint64_t sent = sentNs.load(std::memory_order_acquire);
+            uint64_t now = realtimeNs();
+            uint64_t count;
+            if (read(wakeFd, &count, sizeof(count)) != sizeof(count))
+                continue;
+            // More than one signal since the last read: all but one of them were missed
+            if (count > 1)
+                coalesced.fetch_add(count - 1, std::memory_order_relaxed);
+            if (now >= sent)
+                wakeLatency.add(now - sent);
+        }
+    });
+    configureThread(waiter.native_handle(), label, policy, priority, cpu);
+
+    std::vector<std::thread> loaders;
+    for (long i = 0; i < sysconf(_SC_NPROCESSORS_ONLN); i++)
+        loaders.emplace_back(load, std::ref(running));
+
+    // Signal on an absolute schedule, stamping just before each write
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    long periodNs = static_cast<long>(1e9 / rateHz);
+    for (size_t n = 0; n < expected; n++)
+    {
+        next.tv_nsec += periodNs;
+        while (next.tv_nsec >= 1000000000)
+        {
+            next.tv_nsec -= 1000000000;
+            next.tv_sec++;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr);
+
+        uint64_t one = 1;
+        sentNs.store(realtimeNs(), std::memory_order_release);
+        if (write(wakeFd, &one, sizeof(one)) < 0)
+            perror("eventfd write");
+    }
+
+    running = false;
+    waiter.join();
+    for (std::thread& loader : loaders)
+        loader.join();
+    if (lockMemory)
+        munlockall();
+    close(epollFd);
+    close(wakeFd);
+
+    // Signals that landed while the waiter was still behind collapse into one wakeup
+    LatencyTracker::Summary summary = wakeLatency.summary();
+    LatencyTracker::dump(stdout, label, summary);
+    printf("  %zu of %zu signals missed (waiter more than a period late)\n", std::min(expected, coalesced.load()), expected);
+}
+
+int main(int argc, char** argv)
+{
+    double seconds = argc > 1 ? atof(argv[1]) : 5.0;
+    double rateHz = argc > 2 ? atof(argv[2]) : 1000.0;
+    int priority = argc > 3 ? atoi(argv[3]) : 50;
+    int lastCpu = static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN)) - 1;
+
+    printf("%.0f wakeups/s for %.1f s per run, %d load threads\n", rateHz, seconds, lastCpu + 1);
+    run("other", SCHED_POLICY_OTHER, 0, -1, false, seconds, rateHz);
+    run("fifo", SCHED_POLICY_FIFO, priority, -1, false, seconds, rateHz);
+    run("fifo+pinned", SCHED_POLICY_FIFO, priority, lastCpu, false, seconds, rateHz);
+    run("fifo+pinned+mlockall", SCHED_POLICY_FIFO, priority, lastCpu, true, seconds, rateHz);
+    return 0;
+}
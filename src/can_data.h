@@ -0,0 +1,116 @@
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+
+// Every value the dash can show. Decoders write by index so one table row per signal
+// is enough to route it, and later per-channel state (history, timestamps) lines up.
+enum Channel
+{
+    CH_RPM,
+    CH_SPEED,
+    CH_GEAR,
+    CH_VOLTAGE,
+    CH_IAT,
+    CH_ECT,
+    CH_TPS,
+    CH_MAP,
+    CH_LAMBDA,
+    CH_OIL_TEMP,
+    CH_OIL_PRESSURE,
+    CH_COUNT
+};
+
+inline constexpr const char* channelNames[CH_COUNT] = {
+    "rpm",
+    "speed",
+    "gear",
+    "voltage",
+    "iat",
+    "ect",
+    "tps",
+    "map",
+    "lambda",
+    "oilTemp",
+    "oilPressure",
+};
+
+// Decimal places each channel is shown with on the dash
+inline constexpr int channelDecimals[CH_COUNT] = {
+    0, // rpm
+    0, // speed
+    0, // gear
+    1, // voltage
+    0, // iat
+    0, // ect
+    0, // tps
+    0, // map
+    1, // lambda
+    0, // oilTemp
+    0, // oilPressure
+};
+
+// Build with -DFIXED_POINT_DECODE to keep decoded values as integers in each channel's
+// own unit (a raw CAN field, 0.001 lambda, 0.01 C) and only turn the ones actually
+// drawn into floats, see channelValue(). Default builds decode straight to float.
+#ifdef FIXED_POINT_DECODE
+typedef int32_t ChannelValue;
+#else
+typedef float ChannelValue;
+#endif
+
+// Stored value -> real value for each channel in fixed point builds: value * unit + bias.
+// Depends on the active decoder and config, so main() fills it in before the CAN thread starts.
+struct ChannelScales
+{
+    float unit[CH_COUNT];
+    float bias[CH_COUNT];
+};
+extern ChannelScales channelScales;
+
+inline float channelValue(ChannelValue value, int channel)
+{
+#ifdef FIXED_POINT_DECODE
+    return value * channelScales.unit[channel] + channelScales.bias[channel];
+#else
+    (void)channel;
+    return value;
+#endif
+}
+
+struct CANBusData
+{
+    ChannelValue values[CH_COUNT] = {};
+    uint64_t timestampNs[CH_COUNT] = {}; // Receive time of the frame each value came from, 0 if never seen
+};
+// Test value display
+// struct CANBusData
+// {
+//     float values[CH_COUNT] = { 3500, 80, 4, 14.2, 26, 91, 100, 20, 2.0, 100, 76 };
+// };
+
+inline float channelValue(const CANBusData& data, int channel)
+{
+#ifdef FIXED_POINT_DECODE
+    // A stored 0 means bias once scaled, so channels never received are shown as 0 here
+    if (data.timestampNs[channel] == 0)
+        return 0.0f;
+#endif
+    return channelValue(data.values[channel], channel);
+}
+
+// True if any channel would read differently on screen, i.e. differs once rounded
+// to its display precision
+inline bool displayedValuesDiffer(const CANBusData& a, const CANBusData& b)
+{
+    static constexpr float decimalScale[] = { 1.0f, 10.0f, 100.0f };
+    for (int i = 0; i < CH_COUNT; i++)
+    {
+        if (a.values[i] == b.values[i])
+            continue;
+        float scale = decimalScale[channelDecimals[i]];
+        if (lroundf(channelValue(a, i) * scale) != lroundf(channelValue(b, i) * scale))
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,445 @@
+#pragma once
+
+#include <linux/can.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "can_data.h"
+#include "config.h"
+#include "frame_source.h"
+#include "history.h"
+#include "simd_decode.h"
+#include "thermistor.h"
+
+#define CAN_SFF_ID_COUNT 2048 // Standard 11-bit IDs, the dispatch tables are indexed directly by these
+
+enum SignalType : uint8_t
+{
+    SIGNAL_LINEAR,          // raw * scale + bias
+    SIGNAL_RECIPROCAL,      // scale / raw
+    SIGNAL_THERMISTOR,      // Steinhart-Hart via thermistorTable, result in C
+    SIGNAL_PRESSURE_SENDER, // config.original* -> config.desired* range in kPa, result in psi
+};
+
+// One value packed into a CAN frame
+struct SignalDef
+{
+    uint16_t canId;
+    uint8_t channel;    // Channel it is written to
+    uint8_t offset;     // First data byte
+    uint8_t length;     // 1 or 2 bytes
+    bool bigEndian;
+    SignalType type;
+    float scale;
+    float bias;
+    int32_t invalidRaw; // Raw value the sensor sends when it has nothing, decoded as 0 (-1 if none)
+};
+
+// ------------------------------ Vehicle profiles ------------------------------
+// Rows sharing a CAN ID must be adjacent, ProfileDispatch checks this at compile time.
+
+struct CivicProfile
+{
+    static constexpr const char* name = "civic";
+    static constexpr SignalDef signals[] = {
+        { 660,  CH_RPM,          0, 2, true, SIGNAL_LINEAR,          1.0f,     0.0f, -1 },
+        { 660,  CH_SPEED,        2, 2, true, SIGNAL_LINEAR,          1.0f,     0.0f, -1 },
+        { 660,  CH_GEAR,         4, 1, true, SIGNAL_LINEAR,          1.0f,     0.0f, -1 },
+        { 660,  CH_VOLTAGE,      5, 1, true, SIGNAL_LINEAR,          0.1f,     0.0f, -1 },
+        { 661,  CH_IAT,          0, 2, true, SIGNAL_LINEAR,          1.0f,     0.0f, -1 },
+        { 661,  CH_ECT,          2, 2, true, SIGNAL_LINEAR,          1.0f,     0.0f, -1 },
+        { 662,  CH_TPS,          0, 2, true, SIGNAL_LINEAR,          1.0f,     0.0f, 65535 },
+        { 662,  CH_MAP,          2, 2, true, SIGNAL_LINEAR,          0.1f,     0.0f, -1 },
+        { 664,  CH_LAMBDA,       0, 2, true, SIGNAL_RECIPROCAL,      32768.0f, 0.0f, -1 },
+        { 667,  CH_OIL_TEMP,     0, 2, true, SIGNAL_THERMISTOR,      1.0f,     0.0f, -1 },
+        { 667,  CH_OIL_PRESSURE, 2, 2, true, SIGNAL_PRESSURE_SENDER, 1.0f,     0.0f, -1 },
+        // Same layout again on the 16xx IDs
+        { 1632, CH_RPM,          0, 2, true, SIGNAL_LINEAR,          1.0f,     0.0f, -1 },
+        { 1632, CH_SPEED,        2, 2, true, SIGNAL_LINEAR,          1.0f,     0.0f, -1 },
+        { 1632, CH_GEAR,         4, 1, true, SIGNAL_LINEAR,          1.0f,     0.0f, -1 },
+        { 1632, CH_VOLTAGE,      5, 1, true, SIGNAL_LINEAR,          0.1f,     0.0f, -1 },
+        { 1633, CH_IAT,          0, 2, true, SIGNAL_LINEAR,          1.0f,     0.0f, -1 },
+        { 1633, CH_ECT,          2, 2, true, SIGNAL_LINEAR,          1.0f,     0.0f, -1 },
+        { 1634, CH_TPS,          0, 2, true, SIGNAL_LINEAR,          1.0f,     0.0f, 65535 },
+        { 1634, CH_MAP,          2, 2, true, SIGNAL_LINEAR,          0.1f,     0.0f, -1 },
+        { 1636, CH_LAMBDA,       0, 2, true, SIGNAL_RECIPROCAL,      32768.0f, 0.0f, -1 },
+        { 1639, CH_OIL_TEMP,     0, 2, true, SIGNAL_THERMISTOR,      1.0f,     0.0f, -1 },
+        { 1639, CH_OIL_PRESSURE, 2, 2, true, SIGNAL_PRESSURE_SENDER, 1.0f,     0.0f, -1 },
+    };
+};
+
+struct MazdaProfile
+{
+    static constexpr const char* name = "mazda";
+    static constexpr SignalDef signals[] = {
+        { 201, CH_RPM, 0, 2, true, SIGNAL_LINEAR, 0.25f, 0.0f, -1 },
+        { 201, CH_TPS, 6, 1, true, SIGNAL_LINEAR, 0.5f,  0.0f, -1 },
+        { 513, CH_RPM, 0, 2, true, SIGNAL_LINEAR, 0.25f, 0.0f, -1 },
+        { 513, CH_TPS, 6, 1, true, SIGNAL_LINEAR, 0.5f,  0.0f, -1 },
+    };
+};
+// ------------------------------------------------------------------------------
+
+// Shift byte1 to the left by 8 bits and OR with byte2
+inline uint16_t concatenateBytes(uint8_t byte1, uint8_t byte2)
+{
+    return (static_cast<uint16_t>(byte1) << 8) | byte2;
+}
+
+// Where a CAN ID's rows start in Profile::signals, how many there are, and which
+// WordLanes entry holds its vectorised words
+struct DispatchEntry
+{
+    uint8_t first;
+    uint8_t count;
+    uint8_t lanes;
+};
+
+// Signals decodeWordsBE16 can produce directly: a plain big-endian 16-bit word
+constexpr bool isWordSignal(const SignalDef& signal)
+{
+    return signal.type == SIGNAL_LINEAR && signal.length == 2 && signal.bigEndian && signal.offset % 2 == 0 && signal.offset < 8;
+}
+
+// Direct-indexed ID -> rows table, generated at compile time from Profile::signals
+template <typename Profile>
+struct ProfileDispatch
+{
+    static constexpr size_t signalCount = sizeof(Profile::signals) / sizeof(SignalDef);
+
+    static constexpr bool rowsGrouped()
+    {
+        for (size_t i = 0; i < signalCount; i++)
+            for (size_t j = i + 2; j < signalCount; j++)
+                if (Profile::signals[j].canId == Profile::signals[i].canId && Profile::signals[j - 1].canId != Profile::signals[i].canId)
+                    return false;
+        return true;
+    }
+
+    static constexpr size_t idCount()
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < signalCount; i++)
+            if (i == 0 || Profile::signals[i].canId != Profile::signals[i - 1].canId)
+                count++;
+        return count;
+    }
+
+    static constexpr std::array<DispatchEntry, CAN_SFF_ID_COUNT> build()
+    {
+        std::array<DispatchEntry, CAN_SFF_ID_COUNT> table = {};
+        uint8_t lanes = 0;
+        for (size_t i = 0; i < signalCount; i++)
+        {
+            DispatchEntry& entry = table[Profile::signals[i].canId];
+            if (entry.count == 0)
+            {
+                entry.first = static_cast<uint8_t>(i);
+                entry.lanes = ++lanes;
+            }
+            entry.count++;
+        }
+        return table;
+    }
+
+    // Entry 0 is all unused words, for IDs the profile doesn't know
+    static constexpr std::array<WordLanes, idCount() + 1> buildLanes()
+    {
+        std::array<WordLanes, idCount() + 1> lanes = {};
+        for (WordLanes& lane : lanes)
+            for (int w = 0; w < 4; w++)
+                lane.invalid[w] = -1;
+
+        size_t index = 0;
+        for (size_t i = 0; i < signalCount; i++)
+        {
+            const SignalDef& signal = Profile::signals[i];
+            if (i == 0 || signal.canId != Profile::signals[i - 1].canId)
+                index++;
+            if (isWordSignal(signal))
+            {
+                lanes[index].scale[signal.offset / 2] = signal.scale;
+                lanes[index].bias[signal.offset / 2] = signal.bias;
+                lanes[index].invalid[signal.offset / 2] = signal.invalidRaw;
+            }
+        }
+        return lanes;
+    }
+
+    // Per row: which vectorised word holds its value, or -1 if decodeSignal has to do it
+    static constexpr std::array<int8_t, signalCount> buildWords()
+    {
+        std::array<int8_t, signalCount> words = {};
+        for (size_t i = 0; i < signalCount; i++)
+            words[i] = isWordSignal(Profile::signals[i]) ? static_cast<int8_t>(Profile::signals[i].offset / 2) : -1;
+        return words;
+    }
+
+    // First row of the index-th CAN ID (1-based, as in DispatchEntry::lanes) and its row count
+    static constexpr size_t firstRow(size_t index)
+    {
+        size_t id = 0;
+        for (size_t i = 0; i < signalCount; i++)
+            if ((i == 0 || Profile::signals[i].canId != Profile::signals[i - 1].canId) && ++id == index)
+                return i;
+        return signalCount;
+    }
+
+    static constexpr size_t rowCount(size_t index)
+    {
+        size_t first = firstRow(index), count = 0;
+        while (first + count < signalCount && Profile::signals[first + count].canId == Profile::signals[first].canId)
+            count++;
+        return count;
+    }
+
+    static_assert(signalCount < 256, "Too many signals for an 8-bit dispatch index");
+    static_assert(rowsGrouped(), "Signals sharing a CAN ID must be adjacent");
+
+    static constexpr std::array<DispatchEntry, CAN_SFF_ID_COUNT> table = build();
+    static constexpr std::array<WordLanes, idCount() + 1> lanes = buildLanes();
+    static constexpr std::array<int8_t, signalCount> words = buildWords();
+};
+
+// Unique CAN IDs a profile consumes, in table order
+template <typename Profile>
+std::vector<canid_t> profileCanIds()
+{
+    std::vector<canid_t> ids;
+    for (const SignalDef& signal : Profile::signals)
+        if (ids.empty() || ids.back() != signal.canId)
+            ids.push_back(signal.canId);
+    return ids;
+}
+
+#define RECIPROCAL_FIXED_UNIT 0.001f // Per step of a fixed point reciprocal value (lambda)
+
+// Pressure sender volts -> psi is a straight line through config's ranges
+inline void pressureSenderLine(double& slope, double& intercept)
+{
+    // Calculate the ratio of the original value's position within the original range,
+    // use it to find the equivalent position within the desired range, then kPa -> psi
+    double kPaPerRaw = (config.desiredHigh - config.desiredLow) / (config.originalHigh - config.originalLow);
+    slope = kPaPerRaw * 0.145038;
+    intercept = (config.desiredLow - config.originalLow * kPaPerRaw) * 0.145038;
+}
+
+inline ChannelValue decodeSignal(const SignalDef& signal, const uint8_t* data)
+{
+    uint16_t raw = signal.length == 2
+        ? (signal.bigEndian ? concatenateBytes(data[signal.offset], data[signal.offset + 1])
+                            : concatenateBytes(data[signal.offset + 1], data[signal.offset]))
+        : data[signal.offset];
+
+    if (raw == signal.invalidRaw)
+        return 0;
+
+#ifdef FIXED_POINT_DECODE
+    // Linear and pressure channels keep the raw field, profileChannelScales() has their unit
+    switch (signal.type)
+    {
+        case SIGNAL_LINEAR:
+        case SIGNAL_PRESSURE_SENDER:
+            return raw;
+        case SIGNAL_RECIPROCAL:
+        {
+            if (raw == 0)
+                return 0;
+            uint32_t numerator = static_cast<uint32_t>(signal.scale / RECIPROCAL_FIXED_UNIT);
+            return static_cast<ChannelValue>((numerator + raw / 2) / raw);
+        }
+        case SIGNAL_THERMISTOR:
+            return thermistorTable.lookup(raw);
+    }
+    return 0;
+#else
+    switch (signal.type)
+    {
+        case SIGNAL_LINEAR:
+            return raw * signal.scale + signal.bias;
+        case SIGNAL_RECIPROCAL:
+            return signal.scale / static_cast<float>(raw);
+        case SIGNAL_THERMISTOR:
+            return thermistorTable.lookup(raw);
+        case SIGNAL_PRESSURE_SENDER:
+        {
+            // Calculate the ratio of the original value's position within the original range
+            double ratio = (raw - config.originalLow) / (config.originalHigh - config.originalLow);
+            // Use this ratio to find the equivalent position within the desired range
+            double kPaValue = (ratio * (config.desiredHigh - config.desiredLow)) + config.desiredLow;
+            return static_cast<float>(kPaValue * 0.145038);
+        }
+    }
+    return 0.0f;
+#endif
+}
+
+// Unit and bias of every channel Profile writes when decoded in fixed point. Rows
+// writing the same channel are expected to share a scale.
+template <typename Profile>
+ChannelScales profileChannelScales()
+{
+    ChannelScales scales;
+    for (int i = 0; i < CH_COUNT; i++)
+    {
+        scales.unit[i] = 1.0f;
+        scales.bias[i] = 0.0f;
+    }
+
+    for (const SignalDef& signal : Profile::signals)
+    {
+        switch (signal.type)
+        {
+            case SIGNAL_LINEAR:
+                scales.unit[signal.channel] = signal.scale;
+                scales.bias[signal.channel] = signal.bias;
+                break;
+            case SIGNAL_RECIPROCAL:
+                scales.unit[signal.channel] = RECIPROCAL_FIXED_UNIT;
+                break;
+            case SIGNAL_THERMISTOR:
+                scales.unit[signal.channel] = THERMISTOR_FIXED_UNIT;
+                break;
+            case SIGNAL_PRESSURE_SENDER:
+            {
+                double slope, intercept;
+                pressureSenderLine(slope, intercept);
+                scales.unit[signal.channel] = static_cast<float>(slope);
+                scales.bias[signal.channel] = static_cast<float>(intercept);
+                break;
+            }
+        }
+    }
+    return scales;
+}
+
+// One row with its SignalDef known at compile time, so decodeSignal's length, byte order,
+// invalid value and type checks all fold away
+template <typename Profile, size_t Row>
+inline void decodeRow(const uint8_t* data, uint64_t timestampNs, CANBusData& canData, HistoryStore* history)
+{
+    constexpr const SignalDef& signal = Profile::signals[Row];
+    ChannelValue value = decodeSignal(signal, data);
+    canData.values[signal.channel] = value;
+    canData.timestampNs[signal.channel] = timestampNs;
+    if (history)
+        history->channels[signal.channel].append(timestampNs, value);
+}
+
+template <typename Profile, size_t First, size_t... Rows>
+inline void decodeRows(const uint8_t* data, uint64_t timestampNs, CANBusData& canData, HistoryStore* history, std::index_sequence<Rows...>)
+{
+    (decodeRow<Profile, First + Rows>(data, timestampNs, canData, history), ...);
+}
+
+// Every row of the index-th CAN ID, unrolled
+template <typename Profile, size_t Index>
+inline void decodeId(const uint8_t* data, uint64_t timestampNs, CANBusData& canData, HistoryStore* history)
+{
+    decodeRows<Profile, ProfileDispatch<Profile>::firstRow(Index)>(data, timestampNs, canData, history,
+        std::make_index_sequence<ProfileDispatch<Profile>::rowCount(Index)>());
+}
+
+// Compares canId against each of the profile's IDs in turn, which the compiler can turn into
+// the same jump table a hand-written switch over the IDs gets; extended, RTR and error
+// frames carry flag bits above the 11-bit range and match none
+template <typename Profile, size_t... Indices>
+inline void decodeIds(canid_t canId, const uint8_t* data, uint64_t timestampNs, CANBusData& canData, HistoryStore* history, std::index_sequence<Indices...>)
+{
+    (void)((canId == Profile::signals[ProfileDispatch<Profile>::firstRow(Indices + 1)].canId
+            && (decodeId<Profile, Indices + 1>(data, timestampNs, canData, history), true)) || ...);
+}
+
+// Applies one frame received at timestampNs to canData, and appends each value to its
+// channel's history if one is given. Profile is fixed at compile time, so each ID's rows
+// are expanded into straight-line code with no per-row type switch, like the switch over
+// IDs they replace. Takes the ID and payload directly so socket frames and session log
+// records decode through the same path.
+template <typename Profile>
+inline void decodeFrame(canid_t canId, const uint8_t* data, uint64_t timestampNs, CANBusData& canData, HistoryStore* history = nullptr)
+{
+    decodeIds<Profile>(canId, data, timestampNs, canData, history, std::make_index_sequence<ProfileDispatch<Profile>::idCount()>());
+}
+
+template <typename Profile>
+inline void decodeFrame(const struct can_frame& frame, uint64_t timestampNs, CANBusData& canData, HistoryStore* history = nullptr)
+{
+    decodeFrame<Profile>(frame.can_id, frame.data, timestampNs, canData, history);
+}
+
+// Decodes a whole received batch. The plain 16-bit words of every frame are byte-swapped
+// and scaled together by decodeWordsBE16, then each row takes its vectorised word or
+// falls back to decodeSignal for the types that need more than a multiply-add.
+template <typename Profile>
+inline void decodeBatch(const FrameBatch& batch, int count, CANBusData& canData, HistoryStore* history = nullptr)
+{
+#ifdef FIXED_POINT_DECODE
+    // Fixed point words are the raw field as is, nothing to vectorise
+    for (int i = 0; i < count; i++)
+        decodeFrame<Profile>(batch.frames[i], batch.timestamps[i], canData, history);
+#else
+    alignas(16) float words[CAN_BATCH_SIZE][4];
+    const WordLanes* lanes[CAN_BATCH_SIZE];
+
+    for (int i = 0; i < count; i++)
+    {
+        canid_t canId = batch.frames[i].can_id;
+        lanes[i] = &ProfileDispatch<Profile>::lanes[canId < CAN_SFF_ID_COUNT ? ProfileDispatch<Profile>::table[canId].lanes : 0];
+    }
+    decodeWordsBE16(batch.frames, lanes, count, words);
+
+    for (int i = 0; i < count; i++)
+    {
+        canid_t canId = batch.frames[i].can_id;
+        if (canId >= CAN_SFF_ID_COUNT)
+            continue;
+
+        uint64_t timestampNs = batch.timestamps[i];
+        const DispatchEntry& entry = ProfileDispatch<Profile>::table[canId];
+        for (uint8_t row = entry.first; row < entry.first + entry.count; row++)
+        {
+            const SignalDef& signal = Profile::signals[row];
+            int8_t word = ProfileDispatch<Profile>::words[row];
+            float value = word >= 0 ? words[i][word] : decodeSignal(signal, batch.frames[i].data);
+            canData.values[signal.channel] = value;
+            canData.timestampNs[signal.channel] = timestampNs;
+            if (history)
+                history->channels[signal.channel].append(timestampNs, value);
+        }
+    }
+#endif
+}
+
+// Built-in profile wrapped as a decoder object. readCanData and the log tools take any
+// type with this shape, so a profile and a runtime-loaded DbcDecoder are interchangeable.
+template <typename Profile>
+struct ProfileDecoder
+{
+    const char* name() const
+    {
+        return Profile::name;
+    }
+
+    std::vector<canid_t> canIds() const
+    {
+        return profileCanIds<Profile>();
+    }
+
+    ChannelScales channelScales() const
+    {
+        return profileChannelScales<Profile>();
+    }
+
+    void decode(canid_t canId, const uint8_t* data, uint64_t timestampNs, CANBusData& canData, HistoryStore* history) const
+    {
+        decodeFrame<Profile>(canId, data, timestampNs, canData, history);
+    }
+
+    void decodeBatch(const FrameBatch& batch, int count, CANBusData& canData, HistoryStore* history) const
+    {
+        ::decodeBatch<Profile>(batch, count, canData, history);
+    }
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+enum VehicleProfile
+{
+    VEHICLE_CIVIC,
+    VEHICLE_MAZDA,
+};
+
+enum FrameSourceType
+{
+    SOURCE_SOCKETCAN, // Live bus
+    SOURCE_REPLAY,    // Recorded log, see replayPath
+    SOURCE_SYNTHETIC, // In-process generator, see syntheticStreams
+};
+
+enum RendererBackend
+{
+    RENDERER_GL2,   // imgui_impl_opengl2, fixed function with client side arrays
+    RENDERER_GLES2, // imgui_impl_gles2, shaders and streaming buffers
+};
+
+enum DisplayBackend
+{
+    DISPLAY_GLFW, // Fullscreen GLFW window, needs an X11/Wayland session
+    DISPLAY_KMS,  // imgui_impl_kms straight onto DRM/KMS, only in make KMS=1 builds
+    DISPLAY_HEADLESS, // Offscreen EGL pbuffer, no vsync, renders benchmarkFrames then exits
+};
+
+enum SchedulingPolicy
+{
+    SCHED_POLICY_OTHER, // Normal time sharing
+    SCHED_POLICY_FIFO,
+    SCHED_POLICY_RR,
+};
+
+struct Config
+{
+    VehicleProfile vehicle = VEHICLE_CIVIC; // Decoder table the CAN thread is instantiated with
+    const char* dbcPath = nullptr; // DBC file to build the decoder from instead of the vehicle profile
+    const char* dbcBindings = nullptr; // "DbcSignal=channel,..." for DBC names that aren't channel names
+    FrameSourceType source = SOURCE_SOCKETCAN;
+    const char* canInterface = "can0"; // Comma separated for several buses, e.g. "can0,can1"
+    const char* replayPath = nullptr; // candump/ASC text log or .wrdlog for SOURCE_REPLAY
+    double replaySpeed = 1.0; // 1 = original timing, 2/10 = faster, 0 = as fast as possible
+    bool replayStep = false; // Release one replayed frame per Space press
+    const char* syntheticStreams = nullptr; // "660:100,661:50" (ID:Hz), default is every profile ID at syntheticRateHz
+    double syntheticRateHz = 100.0;
+    bool batchedRead = true; // recvmmsg() batches instead of one recvmsg() per frame
+    bool hardwareTimestamps = false; // Stamp frames with the CAN controller's clock when it has one
+    bool idleRender = true; // Sleep between frames until a shown value changes, input arrives or idleRefreshSeconds passes
+    double idleRefreshSeconds = 1.0;
+    bool logging = true; // Record every received frame to a session log
+    const char* logDirectory = "../logs";
+    const char* fontCacheDirectory = "../cache"; // Baked font atlases, safe to delete
+    DisplayBackend display = DISPLAY_GLFW;
+    const char* kmsDevice = "/dev/dri/card0";
+    int headlessWidth = 1920;
+    int headlessHeight = 1080;
+    int benchmarkFrames = 1000; // Headless frames to render before exiting
+    const char* frameTimesPath = nullptr; // Headless per-frame times CSV, none if null
+    RendererBackend renderer = RENDERER_GL2;
+    bool sdfValues = false; // Draw the big readouts from a distance field atlas instead of a 100 px bitmap font
+    uint32_t logFlushIntervalMs = 500; // Longest a partial log block waits before hitting disk
+    size_t historyBytesPerChannel = 256 * 1024; // Ring memory per channel, allocated once at startup
+    SchedulingPolicy canThreadPolicy = SCHED_POLICY_OTHER; // Real-time policy for the CAN thread, needs CAP_SYS_NICE
+    int canThreadPriority = 0; // 1-99 when canThreadPolicy is FIFO/RR
+    int canThreadCpu = -1; // Pin the CAN thread to this CPU, -1 = any
+    int renderThreadCpu = -1; // Pin the render (main) thread to this CPU, -1 = any
+    bool lockMemory = false; // mlockall() at startup so nothing pages out under the CAN thread
+    double conA = 0.0014222095;
+    double conB = 0.00023729017;
+    double conC = 9.3273998E-8;
+    double originalLow = 0; //0.5;
+    double originalHigh = 5; //4.5;
+    double desiredLow = -100; //0;
+    double desiredHigh = 1100; //1000;
+};
+extern Config config;
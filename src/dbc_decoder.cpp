@@ -0,0 +1,209 @@
+#include "dbc_decoder.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+#include <algorithm>
+
+#define DBC_MAX_LINE 1024
+
+// Channel index for a name, case-insensitive, or -1
+static int channelByName(const char* name)
+{
+    for (int i = 0; i < CH_COUNT; i++)
+        if (strcasecmp(name, channelNames[i]) == 0)
+            return i;
+    return -1;
+}
+
+// Looks signal up in "Signal=channel,..." and returns the channel it is bound to, or -1
+static int boundChannel(const char* bindings, const char* signal)
+{
+    if (!bindings)
+        return -1;
+
+    size_t signalLength = strlen(signal);
+    const char* cursor = bindings;
+    while (*cursor)
+    {
+        const char* equals = strchr(cursor, '=');
+        if (!equals)
+            return -1;
+        const char* end = strchr(equals, ',');
+        size_t nameLength = equals - cursor;
+        size_t channelLength = end ? static_cast<size_t>(end - equals - 1) : strlen(equals + 1);
+
+        if (nameLength == signalLength && strncasecmp(cursor, signal, nameLength) == 0)
+        {
+            std::string channel(equals + 1, channelLength);
+            return channelByName(channel.c_str());
+        }
+
+        if (!end)
+            return -1;
+        cursor = end + 1;
+    }
+    return -1;
+}
+
+bool DbcDecoder::load(const char* path, const char* bindings)
+{
+    FILE* f = fopen(path, "r");
+    if (!f)
+    {
+        perror("DBC open");
+        return false;
+    }
+
+    ops.clear();
+    char line[DBC_MAX_LINE];
+    canid_t messageId = 0;
+    bool inMessage = false;
+    size_t skipped = 0;
+
+    while (fgets(line, sizeof(line), f))
+    {
+        unsigned long rawId;
+        char messageName[128];
+        unsigned dlc;
+        if (sscanf(line, " BO_ %lu %127[^:]: %u", &rawId, messageName, &dlc) == 3)
+        {
+            // Bit 31 marks an extended ID in DBC files
+            messageId = rawId & 0x80000000ul ? (rawId & CAN_EFF_MASK) | CAN_EFF_FLAG : static_cast<canid_t>(rawId);
+            inMessage = true;
+            continue;
+        }
+
+        char signalName[128], multiplex[16];
+        unsigned startBit, length;
+        char byteOrder, sign;
+        double factor, offset;
+        int fields = sscanf(line, " SG_ %127s : %u|%u@%c%c (%lf,%lf)", signalName, &startBit, &length, &byteOrder, &sign, &factor, &offset);
+        if (fields != 7)
+        {
+            fields = sscanf(line, " SG_ %127s %15s : %u|%u@%c%c (%lf,%lf)", signalName, multiplex, &startBit, &length, &byteOrder, &sign, &factor, &offset) - 1;
+            if (fields != 7)
+                continue;
+            if (multiplex[0] == 'm')
+            {
+                // Multiplexed values need the selector decoded first, not supported
+                fprintf(stderr, "DBC: skipping multiplexed signal %s\n", signalName);
+                skipped++;
+                continue;
+            }
+        }
+        if (!inMessage || length == 0 || length > 64 || startBit > 63)
+            continue;
+
+        int channel = boundChannel(bindings, signalName);
+        if (channel < 0)
+            channel = channelByName(signalName);
+        if (channel < 0)
+        {
+            skipped++;
+            continue;
+        }
+
+        DbcSignalOp op;
+        op.canId = messageId;
+        op.channel = static_cast<uint8_t>(channel);
+        op.bigEndian = byteOrder == '0';
+        if (op.bigEndian)
+        {
+            // Motorola: startBit is the MSB in DBC's per-byte numbering. In the
+            // byte-swapped word data[0] is the top byte, so that bit sits at
+            // (7 - byte) * 8 + bit and the LSB is length - 1 below it.
+            int msb = (7 - static_cast<int>(startBit / 8)) * 8 + static_cast<int>(startBit % 8);
+            int lsb = msb - static_cast<int>(length) + 1;
+            if (lsb < 0)
+            {
+                fprintf(stderr, "DBC: signal %s runs past the end of the frame\n", signalName);
+                continue;
+            }
+            op.shift = static_cast<uint8_t>(lsb);
+        } else {
+            if (startBit + length > 64)
+            {
+                fprintf(stderr, "DBC: signal %s runs past the end of the frame\n", signalName);
+                continue;
+            }
+            op.shift = static_cast<uint8_t>(startBit);
+        }
+        op.mask = length == 64 ? ~0ull : (1ull << length) - 1;
+        op.signBit = sign == '-' ? 1ull << (length - 1) : 0;
+        op.factor = static_cast<float>(factor);
+        op.offset = static_cast<float>(offset);
+
+#ifdef FIXED_POINT_DECODE
+        // One unit per channel, so a second signal on it has to scale the same way
+        bool conflicting = false;
+        for (const DbcSignalOp& other : ops)
+            if (other.channel == op.channel && (other.factor != op.factor || other.offset != op.offset))
+                conflicting = true;
+        if (conflicting)
+        {
+            fprintf(stderr, "DBC: signal %s scales %s differently to an earlier signal, skipped\n", signalName, channelNames[channel]);
+            skipped++;
+            continue;
+        }
+#endif
+        ops.push_back(op);
+    }
+    fclose(f);
+
+    if (ops.empty())
+    {
+        fprintf(stderr, "%s: no DBC signals matched a dash channel\n", path);
+        return false;
+    }
+
+    // Group ops by ID (keeping file order within a message) and build the dispatch tables
+    std::stable_sort(ops.begin(), ops.end(), [](const DbcSignalOp& a, const DbcSignalOp& b) { return a.canId < b.canId; });
+    for (size_t i = 0; i < ops.size(); i++)
+    {
+        DbcDispatch* entry;
+        if (ops[i].canId < CAN_SFF_ID_COUNT)
+            entry = &standardTable[ops[i].canId];
+        else
+        {
+            if (extendedIds.empty() || extendedIds.back() != ops[i].canId)
+            {
+                extendedIds.push_back(ops[i].canId);
+                extendedTable.push_back({ 0, 0 });
+            }
+            entry = &extendedTable.back();
+        }
+        if (entry->count == 0)
+            entry->first = static_cast<uint16_t>(i);
+        entry->count++;
+    }
+
+    printf("DBC: %zu signals bound to dash channels from %s (%zu skipped)\n", ops.size(), path, skipped);
+    return true;
+}
+
+std::vector<canid_t> DbcDecoder::canIds() const
+{
+    std::vector<canid_t> ids;
+    for (const DbcSignalOp& op : ops)
+        if (ids.empty() || ids.back() != op.canId)
+            ids.push_back(op.canId);
+    return ids;
+}
+
+ChannelScales DbcDecoder::channelScales() const
+{
+    ChannelScales scales;
+    for (int i = 0; i < CH_COUNT; i++)
+    {
+        scales.unit[i] = 1.0f;
+        scales.bias[i] = 0.0f;
+    }
+    for (const DbcSignalOp& op : ops)
+    {
+        scales.unit[op.channel] = op.factor;
+        scales.bias[op.channel] = op.offset;
+    }
+    return scales;
+}
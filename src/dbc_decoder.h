@@ -0,0 +1,118 @@
+#pragma once
+
+#include <linux/can.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "can_data.h"
+#include "can_decoder.h"
+#include "history.h"
+
+// Decoder compiled at startup from a standard DBC file, for signals that aren't in a
+// built-in profile. Every BO_/SG_ whose signal name matches a dash channel (or is
+// bound to one explicitly) becomes one DbcSignalOp; ops for the same CAN ID sit next
+// to each other and are found through a direct-indexed table like ProfileDispatch.
+// Decoding an op is a fixed shift/mask/sign-extend/scale with no per-signal branches:
+// byte order picks which of two pre-swapped words to read, and unsigned signals just
+// have a zero sign bit.
+class DbcDecoder
+{
+public:
+    // bindings is an optional "DbcSignal=channel,..." list for signals whose DBC name
+    // doesn't match a channel name. Returns false if nothing could be bound.
+    bool load(const char* path, const char* bindings);
+
+    const char* name() const
+    {
+        return "dbc";
+    }
+
+    std::vector<canid_t> canIds() const;
+
+    // Each bound channel's DBC factor and offset, for fixed point builds
+    ChannelScales channelScales() const;
+
+    void decode(canid_t canId, const uint8_t* data, uint64_t timestampNs, CANBusData& canData, HistoryStore* history) const
+    {
+        const DbcDispatch* entry = find(canId);
+        if (!entry || entry->count == 0)
+            return;
+
+        uint64_t littleEndian;
+        memcpy(&littleEndian, data, sizeof(littleEndian)); // Host is little-endian
+        uint64_t words[2] = { littleEndian, __builtin_bswap64(littleEndian) };
+
+        for (uint16_t i = entry->first; i < entry->first + entry->count; i++)
+        {
+            const DbcSignalOp& op = ops[i];
+            uint64_t raw = (words[op.bigEndian] >> op.shift) & op.mask;
+            int64_t value = static_cast<int64_t>(raw ^ op.signBit) - static_cast<int64_t>(op.signBit);
+#ifdef FIXED_POINT_DECODE
+            ChannelValue scaled = static_cast<ChannelValue>(value); // channelScales() has factor and offset
+#else
+            ChannelValue scaled = static_cast<float>(value) * op.factor + op.offset;
+#endif
+
+            canData.values[op.channel] = scaled;
+            canData.timestampNs[op.channel] = timestampNs;
+            if (history)
+                history->channels[op.channel].append(timestampNs, scaled);
+        }
+    }
+
+    // DBC ops are already one shift/mask/scale each, so a batch is just every frame in turn
+    void decodeBatch(const FrameBatch& batch, int count, CANBusData& canData, HistoryStore* history) const
+    {
+        for (int i = 0; i < count; i++)
+            decode(batch.frames[i].can_id, batch.frames[i].data, batch.timestamps[i], canData, history);
+    }
+
+    size_t signalCount() const
+    {
+        return ops.size();
+    }
+
+private:
+    struct DbcSignalOp
+    {
+        canid_t canId;     // Including CAN_EFF_FLAG for extended IDs
+        uint8_t channel;
+        uint8_t shift;     // Of the signal's LSB within the chosen 64-bit word
+        uint8_t bigEndian; // Index into the words array: 0 = Intel, 1 = Motorola
+        uint64_t mask;
+        uint64_t signBit;  // 0 for unsigned signals
+        float factor;
+        float offset;
+    };
+
+    struct DbcDispatch
+    {
+        uint16_t first;
+        uint16_t count;
+    };
+
+    const DbcDispatch* find(canid_t canId) const
+    {
+        if (canId < CAN_SFF_ID_COUNT)
+            return &standardTable[canId];
+
+        // Extended IDs are rare on the dash's buses, a binary search over them is fine
+        size_t low = 0, high = extendedIds.size();
+        while (low < high)
+        {
+            size_t mid = (low + high) / 2;
+            if (extendedIds[mid] < canId)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+        return low < extendedIds.size() && extendedIds[low] == canId ? &extendedTable[low] : nullptr;
+    }
+
+    std::vector<DbcSignalOp> ops;
+    std::vector<DbcDispatch> standardTable = std::vector<DbcDispatch>(CAN_SFF_ID_COUNT);
+    std::vector<canid_t> extendedIds; // Sorted, parallel to extendedTable
+    std::vector<DbcDispatch> extendedTable;
+};
@@ -0,0 +1,195 @@
+#include "font_cache.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <vector>
+
+#define FONT_CACHE_MAGIC "WRDFNT1"
+
+struct FontCacheHeader
+{
+    char magic[8];
+    uint64_t key;
+    int32_t texWidth;
+    int32_t texHeight;
+    ImVec2 texUvScale;
+    ImVec2 texUvWhitePixel;
+    ImVec4 texUvLines[IM_DRAWLIST_TEX_LINES_WIDTH_MAX + 1];
+    int32_t fontCount;
+};
+
+struct FontCacheFont
+{
+    float fontSize;
+    float ascent;
+    float descent;
+    int32_t glyphCount;
+};
+
+// FNV-1a, plenty to tell font files and settings apart
+static uint64_t hashBytes(uint64_t hash, const void* data, size_t size)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++)
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    return hash;
+}
+
+bool fontCacheKey(const FontSpec* specs, int count, uint64_t& key)
+{
+    key = 0xcbf29ce484222325ull;
+    int version = IMGUI_VERSION_NUM;
+    size_t glyphSize = sizeof(ImFontGlyph);
+    key = hashBytes(key, &version, sizeof(version));
+    key = hashBytes(key, &glyphSize, sizeof(glyphSize));
+
+    for (int i = 0; i < count; i++)
+    {
+        FILE* f = fopen(specs[i].path, "rb");
+        if (!f)
+            return false;
+        char buffer[65536];
+        size_t length;
+        while ((length = fread(buffer, 1, sizeof(buffer), f)) > 0)
+            key = hashBytes(key, buffer, length);
+        fclose(f);
+
+        key = hashBytes(key, &specs[i].sizePixels, sizeof(specs[i].sizePixels));
+        for (const ImWchar* range = specs[i].ranges; range && *range; range++)
+            key = hashBytes(key, range, sizeof(*range));
+    }
+    return true;
+}
+
+static bool readCache(ImFontAtlas* atlas, const char* path, uint64_t key, int count)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f)
+        return false;
+
+    FontCacheHeader header;
+    bool ok = fread(&header, sizeof(header), 1, f) == 1
+        && memcmp(header.magic, FONT_CACHE_MAGIC, sizeof(header.magic)) == 0
+        && header.key == key && header.fontCount == count
+        && header.texWidth > 0 && header.texHeight > 0;
+
+    atlas->Clear();
+    for (int i = 0; ok && i < count; i++)
+    {
+        FontCacheFont fontHeader;
+        ok = fread(&fontHeader, sizeof(fontHeader), 1, f) == 1 && fontHeader.glyphCount > 0;
+        if (!ok)
+            break;
+
+        // Same state ImFontAtlasBuildSetupFont() and AddGlyph() leave behind, minus the
+        // ImFontConfig the font was baked from, which only the bake itself needs
+        ImFont* font = IM_NEW(ImFont);
+        atlas->Fonts.push_back(font);
+        font->ContainerAtlas = atlas;
+        font->FontSize = fontHeader.fontSize;
+        font->Ascent = fontHeader.ascent;
+        font->Descent = fontHeader.descent;
+        font->Glyphs.resize(fontHeader.glyphCount);
+        ok = fread(font->Glyphs.Data, sizeof(ImFontGlyph), fontHeader.glyphCount, f) == static_cast<size_t>(fontHeader.glyphCount);
+        if (ok)
+            font->BuildLookupTable();
+    }
+
+    if (ok)
+    {
+        size_t pixelCount = static_cast<size_t>(header.texWidth) * header.texHeight;
+        atlas->TexPixelsAlpha8 = static_cast<unsigned char*>(IM_ALLOC(pixelCount));
+        ok = fread(atlas->TexPixelsAlpha8, 1, pixelCount, f) == pixelCount;
+    }
+    fclose(f);
+
+    if (!ok)
+    {
+        atlas->Clear();
+        return false;
+    }
+
+    atlas->TexWidth = header.texWidth;
+    atlas->TexHeight = header.texHeight;
+    atlas->TexUvScale = header.texUvScale;
+    atlas->TexUvWhitePixel = header.texUvWhitePixel;
+    memcpy(atlas->TexUvLines, header.texUvLines, sizeof(atlas->TexUvLines));
+    atlas->TexReady = true;
+    return true;
+}
+
+static void writeCache(const ImFontAtlas* atlas, const char* path, uint64_t key)
+{
+    // Written beside the real name and renamed, so a power cut never leaves half a cache
+    char tempPath[512];
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+    FILE* f = fopen(tempPath, "wb");
+    if (!f)
+    {
+        perror("Font cache");
+        return;
+    }
+
+    FontCacheHeader header = {};
+    memcpy(header.magic, FONT_CACHE_MAGIC, sizeof(header.magic));
+    header.key = key;
+    header.texWidth = atlas->TexWidth;
+    header.texHeight = atlas->TexHeight;
+    header.texUvScale = atlas->TexUvScale;
+    header.texUvWhitePixel = atlas->TexUvWhitePixel;
+    memcpy(header.texUvLines, atlas->TexUvLines, sizeof(header.texUvLines));
+    header.fontCount = atlas->Fonts.Size;
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+
+    for (const ImFont* font : atlas->Fonts)
+    {
+        FontCacheFont fontHeader = { font->FontSize, font->Ascent, font->Descent, font->Glyphs.Size };
+        ok = ok && fwrite(&fontHeader, sizeof(fontHeader), 1, f) == 1;
+        ok = ok && fwrite(font->Glyphs.Data, sizeof(ImFontGlyph), font->Glyphs.Size, f) == static_cast<size_t>(font->Glyphs.Size);
+    }
+
+    size_t pixelCount = static_cast<size_t>(atlas->TexWidth) * atlas->TexHeight;
+    ok = ok && fwrite(atlas->TexPixelsAlpha8, 1, pixelCount, f) == pixelCount;
+    ok = fclose(f) == 0 && ok;
+
+    if (!ok || rename(tempPath, path) != 0)
+    {
+        perror("Font cache");
+        remove(tempPath);
+    }
+}
+
+bool loadFontsCached(ImFontAtlas* atlas, const FontSpec* specs, int count, const char* cacheDirectory, bool& fromCache)
+{
+    fromCache = false;
+
+    // The cached atlas has no mouse cursor shapes, so the baked one mustn't either
+    atlas->Flags |= ImFontAtlasFlags_NoMouseCursors;
+
+    uint64_t key;
+    if (!fontCacheKey(specs, count, key))
+    {
+        fprintf(stderr, "Can't read font %s\n", specs[0].path);
+        return false;
+    }
+
+    char cachePath[512];
+    snprintf(cachePath, sizeof(cachePath), "%s/fonts-%016llx.atlas", cacheDirectory, (unsigned long long)key);
+    if (readCache(atlas, cachePath, key, count))
+    {
+        fromCache = true;
+        return true;
+    }
+
+    for (int i = 0; i < count; i++)
+        if (!atlas->AddFontFromFileTTF(specs[i].path, specs[i].sizePixels, nullptr, specs[i].ranges))
+            return false;
+    if (!atlas->Build())
+        return false;
+
+    mkdir(cacheDirectory, 0755);
+    writeCache(atlas, cachePath, key);
+    return true;
+}
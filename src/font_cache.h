@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "imgui.h"
+
+// One font to put in the atlas
+struct FontSpec
+{
+    const char* path;
+    float sizePixels;
+    const ImWchar* ranges;
+};
+
+// Fills atlas with specs' fonts, atlas->Fonts[i] being specs[i]. Rasterising a 100 px
+// font with stb_truetype is most of the dash's startup, so the finished atlas (Alpha8
+// pixels plus glyph metrics) is saved in cacheDirectory keyed by a hash of the font
+// files, sizes, ranges and ImGui version, and loaded as is on later boots. fromCache
+// says which happened. Returns false if a font file couldn't be loaded.
+bool loadFontsCached(ImFontAtlas* atlas, const FontSpec* specs, int count, const char* cacheDirectory, bool& fromCache);
+
+// The hash the cache is keyed by, for other baked font data kept in the same directory.
+// False if a font file can't be read.
+bool fontCacheKey(const FontSpec* specs, int count, uint64_t& key);
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <linux/can.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define CAN_BATCH_SIZE 64 // Max frames handed to the decoder per receive() call
+
+// Frames handed from a FrameSource to the CAN thread, preallocated so the loop never allocates
+struct FrameBatch
+{
+    struct can_frame frames[CAN_BATCH_SIZE];
+    uint64_t timestamps[CAN_BATCH_SIZE]; // Arrival time of each frame, CLOCK_REALTIME ns
+};
+
+// Where the CAN thread gets its frames from
+class FrameSource
+{
+public:
+    virtual ~FrameSource() = default;
+
+    // Fills batch with up to CAN_BATCH_SIZE frames, waiting for the first. Returns the
+    // number of frames, 0 if it gave up waiting (e.g. interrupted), or -1 once the
+    // source is finished or has failed (it prints why).
+    virtual int receive(FrameBatch& batch) = 0;
+
+    virtual const char* name() const = 0;
+
+    // Makes a receive() blocked in another thread return 0 promptly, so the CAN thread
+    // can see running == false. Sources whose waits are already short (replay and
+    // synthetic sleep at most 100 ms) needn't override it.
+    virtual void interrupt()
+    {
+    }
+
+    // Per-input counters for the debug overlay, e.g. one input per CAN interface
+    virtual size_t inputCount() const
+    {
+        return 0;
+    }
+
+    virtual const char* inputName(size_t) const
+    {
+        return "";
+    }
+
+    virtual uint64_t inputFrames(size_t) const
+    {
+        return 0;
+    }
+
+    // Frames the input received since it was opened, including ones filtered out before
+    // they reached us; 0 if unknown. May read sysfs, so not for every frame.
+    virtual uint64_t inputFramesSeen(size_t) const
+    {
+        return 0;
+    }
+};
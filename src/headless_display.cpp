@@ -0,0 +1,116 @@
+#include "headless_display.h"
+
+#include <math.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GL/gl.h>
+
+static EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+static EGLContext eglContext = EGL_NO_CONTEXT;
+static EGLSurface eglSurface = EGL_NO_SURFACE;
+static int wakeFd = -1;
+
+static EGLDisplay openEglDisplay()
+{
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay)
+    {
+        EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr))
+            return display;
+    }
+
+    EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr))
+        return display;
+    return EGL_NO_DISPLAY;
+}
+
+bool createHeadlessContext(int width, int height)
+{
+    eglDisplay = openEglDisplay();
+    if (eglDisplay == EGL_NO_DISPLAY)
+    {
+        fprintf(stderr, "Headless: no EGL display (0x%04x)\n", eglGetError());
+        return false;
+    }
+
+    // Desktop GL so both the GL2 and GLES2 renderers run on it as they do under GLFW
+    static const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig eglConfig;
+    EGLint configCount = 0;
+    if (!eglBindAPI(EGL_OPENGL_API) || !eglChooseConfig(eglDisplay, configAttribs, &eglConfig, 1, &configCount) || configCount == 0)
+    {
+        fprintf(stderr, "Headless: no desktop GL pbuffer config (0x%04x)\n", eglGetError());
+        destroyHeadlessContext();
+        return false;
+    }
+
+    const EGLint surfaceAttribs[] = { EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE };
+    eglSurface = eglCreatePbufferSurface(eglDisplay, eglConfig, surfaceAttribs);
+    eglContext = eglCreateContext(eglDisplay, eglConfig, EGL_NO_CONTEXT, nullptr);
+    if (eglSurface == EGL_NO_SURFACE || eglContext == EGL_NO_CONTEXT || !eglMakeCurrent(eglDisplay, eglSurface, eglSurface, eglContext))
+    {
+        fprintf(stderr, "Headless: can't create a %dx%d pbuffer context (0x%04x)\n", width, height, eglGetError());
+        destroyHeadlessContext();
+        return false;
+    }
+
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    printf("Headless: %dx%d pbuffer on %s\n", width, height, (const char*)glGetString(GL_RENDERER));
+    return true;
+}
+
+void destroyHeadlessContext()
+{
+    if (eglDisplay == EGL_NO_DISPLAY)
+        return;
+
+    eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (eglContext != EGL_NO_CONTEXT)
+        eglDestroyContext(eglDisplay, eglContext);
+    if (eglSurface != EGL_NO_SURFACE)
+        eglDestroySurface(eglDisplay, eglSurface);
+    eglTerminate(eglDisplay);
+    if (wakeFd >= 0)
+        close(wakeFd);
+    wakeFd = -1;
+    eglDisplay = EGL_NO_DISPLAY;
+    eglContext = EGL_NO_CONTEXT;
+    eglSurface = EGL_NO_SURFACE;
+}
+
+void headlessWaitEvents(double timeoutSeconds)
+{
+    if (timeoutSeconds <= 0.0 || wakeFd < 0)
+        return;
+
+    struct pollfd wake = { wakeFd, POLLIN, 0 };
+    if (poll(&wake, 1, (int)ceil(timeoutSeconds * 1000.0)) > 0)
+    {
+        uint64_t count;
+        if (read(wakeFd, &count, sizeof(count)) < 0)
+        {
+            // Already drained
+        }
+    }
+}
+
+void headlessPostEmptyEvent()
+{
+    uint64_t one = 1;
+    if (wakeFd >= 0 && write(wakeFd, &one, sizeof(one)) < 0)
+    {
+        // Counter full, the render thread is already due to wake
+    }
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+// Offscreen EGL pbuffer of width x height with a desktop GL context made current, for
+// rendering the dash with no monitor or display server (benchmarks, CI). Uses Mesa's
+// surfaceless platform when there is one, so it works without /dev/dri (llvmpipe).
+// Nothing is ever shown and there is no vsync. Returns false (and says why) on failure.
+bool createHeadlessContext(int width, int height);
+void destroyHeadlessContext();
+
+// glfwWaitEventsTimeout()/glfwPostEmptyEvent() stand-ins, so idle rendering works headless:
+// sleeps until a post or timeoutSeconds passes (0 returns at once)
+void headlessWaitEvents(double timeoutSeconds);
+void headlessPostEmptyEvent(); // Any thread
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <new>
+
+#include "can_data.h"
+
+#define HISTORY_ALIGNMENT 64 // Cache line
+
+// Fixed-capacity ring of (timestamp, value) samples for one channel, kept as two
+// separate arrays (structure of arrays) so windowed reads stream through memory.
+// Single writer (CAN thread), any number of readers; nothing allocates after init().
+// Slots are relaxed atomics so a reader racing the writer is well defined; readers
+// detect and drop any sample the writer lapped while they were copying.
+class ChannelHistory
+{
+public:
+    ChannelHistory() = default;
+    ChannelHistory(const ChannelHistory&) = delete;
+    ChannelHistory& operator=(const ChannelHistory&) = delete;
+
+    ~ChannelHistory()
+    {
+        release();
+    }
+
+    // Capacity is rounded down to a power of two (minimum 2)
+    void init(size_t requestedCapacity)
+    {
+        release();
+
+        capacity = 2;
+        while (capacity * 2 <= requestedCapacity)
+            capacity *= 2;
+
+        timestamps = new (std::align_val_t(HISTORY_ALIGNMENT)) std::atomic<uint64_t>[capacity];
+        values = new (std::align_val_t(HISTORY_ALIGNMENT)) std::atomic<ChannelValue>[capacity];
+        head.store(0, std::memory_order_relaxed);
+    }
+
+    // Writer thread only, O(1)
+    void append(uint64_t timestampNs, ChannelValue value)
+    {
+        uint64_t index = head.load(std::memory_order_relaxed);
+        // Keeps the slot stores after anything a reader already saw through head, as the
+        // fence in SnapshotBuffer::publish does for its payload
+        std::atomic_thread_fence(std::memory_order_release);
+        timestamps[index & (capacity - 1)].store(timestampNs, std::memory_order_relaxed);
+        values[index & (capacity - 1)].store(value, std::memory_order_relaxed);
+        head.store(index + 1, std::memory_order_release);
+    }
+
+    // Copies up to maxSamples of the newest samples taken at or after sinceNs, oldest
+    // first, into the caller's arrays. Returns how many were copied.
+    size_t read(uint64_t sinceNs, uint64_t* outTimestamps, ChannelValue* outValues, size_t maxSamples) const
+    {
+        if (!timestamps)
+            return 0;
+
+        uint64_t end = head.load(std::memory_order_acquire);
+        uint64_t available = end < capacity ? end : capacity;
+        if (available > maxSamples)
+            available = maxSamples;
+
+        // Walk back from the newest sample until we pass sinceNs
+        uint64_t begin = end;
+        while (begin > end - available && timestamps[(begin - 1) & (capacity - 1)].load(std::memory_order_relaxed) >= sinceNs)
+            begin--;
+
+        size_t count = 0;
+        for (uint64_t i = begin; i < end; i++, count++)
+        {
+            outTimestamps[count] = timestamps[i & (capacity - 1)].load(std::memory_order_relaxed);
+            outValues[count] = values[i & (capacity - 1)].load(std::memory_order_relaxed);
+        }
+
+        // The writer may be mid-way through slot `after`, so only the capacity - 1 samples
+        // before it are known to be intact
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t after = head.load(std::memory_order_relaxed);
+        uint64_t oldestValid = after >= capacity ? after - capacity + 1 : 0;
+        if (begin < oldestValid)
+        {
+            size_t lapped = static_cast<size_t>(oldestValid - begin);
+            if (lapped >= count)
+                return 0;
+            for (size_t i = lapped; i < count; i++)
+            {
+                outTimestamps[i - lapped] = outTimestamps[i];
+                outValues[i - lapped] = outValues[i];
+            }
+            count -= lapped;
+        }
+        return count;
+    }
+
+    size_t size() const
+    {
+        return capacity;
+    }
+
+private:
+    void release()
+    {
+        if (timestamps)
+            ::operator delete[](timestamps, std::align_val_t(HISTORY_ALIGNMENT));
+        if (values)
+            ::operator delete[](values, std::align_val_t(HISTORY_ALIGNMENT));
+        timestamps = nullptr;
+        values = nullptr;
+    }
+
+    std::atomic<uint64_t>* timestamps = nullptr;
+    std::atomic<ChannelValue>* values = nullptr;
+    size_t capacity = 0;
+    alignas(HISTORY_ALIGNMENT) std::atomic<uint64_t> head{0}; // Total samples ever appended
+};
+
+// One history ring per dash channel
+struct HistoryStore
+{
+    ChannelHistory channels[CH_COUNT];
+
+    // Sizes every ring to fit bytesPerChannel (timestamp + value per sample)
+    void init(size_t bytesPerChannel)
+    {
+        size_t samples = bytesPerChannel / (sizeof(uint64_t) + sizeof(ChannelValue));
+        for (ChannelHistory& channel : channels)
+            channel.init(samples);
+    }
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+
+// Rolling window of data-age samples for one point in the frame, e.g. how old the
+// newest CAN value was when ImGui::Render() ran. One thread per tracker; other threads
+// see it through a published Summary.
+class LatencyTracker
+{
+public:
+    struct Summary
+    {
+        size_t samples = 0;
+        double p50Ms = 0.0;
+        double p99Ms = 0.0;
+        double maxMs = 0.0;
+    };
+
+    explicit LatencyTracker(const char* name, size_t window = 1024)
+        : name(name), samples(window), sorted(window)
+    {
+    }
+
+    void add(uint64_t ageNs)
+    {
+        samples[next] = ageNs;
+        next = (next + 1) % samples.size();
+        if (count < samples.size())
+            count++;
+    }
+
+    Summary summary()
+    {
+        Summary result;
+        result.samples = count;
+        if (count == 0)
+            return result;
+
+        sorted.assign(samples.begin(), samples.begin() + count);
+        std::sort(sorted.begin(), sorted.end());
+        result.p50Ms = sorted[(count - 1) / 2] / 1e6;
+        result.p99Ms = sorted[(count - 1) * 99 / 100] / 1e6;
+        result.maxMs = sorted[count - 1] / 1e6;
+        return result;
+    }
+
+    // One line per tracker: name=data@swap samples=1024 p50_ms=... p99_ms=... max_ms=...
+    void dump(FILE* out)
+    {
+        dump(out, name, summary());
+    }
+
+    // Same line for a summary taken elsewhere, e.g. published by another thread
+    static void dump(FILE* out, const char* name, const Summary& s)
+    {
+        fprintf(out, "name=%s samples=%zu p50_ms=%.3f p99_ms=%.3f max_ms=%.3f\n", name, s.samples, s.p50Ms, s.p99Ms, s.maxMs);
+    }
+
+    const char* name;
+
+private:
+    std::vector<uint64_t> samples; // Ring of the last window ages in ns
+    std::vector<uint64_t> sorted;  // Scratch for percentiles, sized once so summary() never allocates
+    size_t next = 0;
+    size_t count = 0;
+};
@@ -3,6 +3,10 @@
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl2.h"
+#include "imgui_impl_gles2.h"
+#ifdef KMS_DISPLAY
+#include "imgui_impl_kms.h"
+#endif
 #include <stdio.h>
 #include <GLFW/glfw3.h>
 
@@ -12,169 +16,667 @@
 #include <string.h>
 #include <sys/socket.h>
 #include <linux/can.h>
-#include <linux/if.h>
-#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <getopt.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <errno.h>
 #include <iostream>
 #include <typeinfo>
 #include <vector>
 #include <cstdint> // for uint8_t
 #include <atomic>
-#include <mutex>
 #include <thread>
+#include <memory>
 #include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <time.h>
+
+#include "config.h"
+#include "can_data.h"
+#include "can_decoder.h"
+#include "dbc_decoder.h"
+#include "snapshot.h"
+#include "timestamp.h"
+#include "latency.h"
+#include "history.h"
+#include "session_logger.h"
+#include "frame_source.h"
+#include "socketcan_source.h"
+#include "replay_source.h"
+#include "synthetic_source.h"
+#include "realtime.h"
+#include "font_cache.h"
+#include "sdf_font.h"
+#include "headless_display.h"
 
-#define CAN_INTERFACE "can0"
 #define CAN_FRAME_SIZE 8
 
 #pragma endregion Includes Region
 
-struct Config
+Config config;
+ThermistorTable thermistorTable;
+HistoryStore history;
+ChannelScales channelScales;
+SessionLogger sessionLogger;
+
+static void glfw_error_callback(int error, const char* description)
 {
-    bool civic = true;
-    bool mazda = false;
-    double conA = 0.0014222095;
-    double conB = 0.00023729017;
-    double conC = 9.3273998E-8;
-    double originalLow = 0; //0.5;
-    double originalHigh = 5; //4.5;
-    double desiredLow = -100; //0;
-    double desiredHigh = 1100; //1000;
+    fprintf(stderr, "GLFW Error %d: %s\n", error, description);
+}
+
+// Reader-side counters, shown in the debug overlay
+struct CanStats
+{
+    std::atomic<uint64_t> framesAccepted{0}; // Frames that made it through the kernel filter
+    std::atomic<uint64_t> readCalls{0};      // FrameSource::receive() calls that returned frames
 };
-Config config;
+CanStats canStats;
 
-struct CANBusData
+// Lets the CAN thread nudge an idle render loop when something on screen changed.
+// Only the first change after each frame posts a wakeup, so a busy bus can't flood
+// the event queue.
+struct RenderWakeup
 {
-    float rpm = 0.0;
-    int speed = 0;
-    int gear = 0;
-    float voltage = 0.0;
-    int iat = 0;
-    int ect = 0;
-    int tps = 0;
-    int map = 0;
-    float lambdaRatio = 0.0;
-    double oilTemp = 0.0;
-    double oilPressure = 0.0;
+    std::atomic<bool> pending{false};
+    void (*wake)() = nullptr; // Must be safe to call from any thread
+
+    void notify()
+    {
+        if (!pending.exchange(true, std::memory_order_acq_rel) && wake)
+            wake();
+    }
+
+    // Render thread, once per frame, before reading the snapshot. A read-modify-write
+    // rather than a store: it orders the snapshot read after the clear, so a notify()
+    // that still sees pending set was published before the clear and this frame shows it.
+    void clear()
+    {
+        pending.exchange(false, std::memory_order_acq_rel);
+    }
 };
-// Test value display
-// struct CANBusData
-// {
-//     float rpm = 3500.0;
-//     int speed = 80;
-//     int gear = 4;
-//     float voltage = 14.2;
-//     int iat = 26;
-//     int ect = 91;
-//     int tps = 100;
-//     int map = 20;
-//     float lambdaRatio = 2.0;
-//     double oilTemp = 100;
-//     double oilPressure = 76;
-// };
+RenderWakeup renderWakeup;
 
-static void glfw_error_callback(int error, const char* description)
+// Frame arrival (kernel stamp, or due time for synthetic frames) to the CAN thread having
+// it in hand, i.e. how late the thread got scheduled. Only the CAN thread touches the
+// tracker; it publishes a summary once a second for the overlay and F2.
+LatencyTracker canWakeTracker("can wake");
+SnapshotBuffer<LatencyTracker::Summary> canWakeSummary;
+
+// Decodes into a private CANBusData and publishes a copy after every batch, so the
+// render loop only ever sees whole updates and this thread never waits on it.
+// Every decoded value is also appended to its channel's history, and every raw frame
+// is handed to the session logger when there is one. decoder is a ProfileDecoder, whose
+// tables are baked in at compile time, or a DbcDecoder loaded at startup.
+template <typename Decoder>
+void readCanData(const Decoder& decoder, FrameSource& source, std::atomic<bool>& running, SnapshotBuffer<CANBusData>& canSnapshot, HistoryStore& history, SessionLogger* logger)
 {
-    fprintf(stderr, "GLFW Error %d: %s\n", error, description);
+    FrameBatch batch;
+    CANBusData canData;
+    CANBusData lastShown; // Last values we woke the renderer for
+    uint64_t lastSummaryNs = 0;
+
+    while (running) {
+        int count = source.receive(batch);
+        if (count > 0)
+        {
+            uint64_t now = realtimeNs();
+            canWakeTracker.add(now > batch.timestamps[0] ? now - batch.timestamps[0] : 0);
+            if (now - lastSummaryNs >= 1000000000ull)
+            {
+                canWakeSummary.publish(canWakeTracker.summary());
+                lastSummaryNs = now;
+            }
+
+            canStats.framesAccepted.fetch_add(count, std::memory_order_relaxed);
+            canStats.readCalls.fetch_add(1, std::memory_order_relaxed);
+
+            // Frame at a time: decodeBatch's SIMD word extraction still loses to the
+            // unrolled per-frame decode in bench/decode_bench
+            for (int i = 0; i < count; i++)
+                decoder.decode(batch.frames[i].can_id, batch.frames[i].data, batch.timestamps[i], canData, &history);
+
+            if (logger)
+                for (int i = 0; i < count; i++)
+                    logger->push(batch.frames[i], batch.timestamps[i]);
+
+            canSnapshot.publish(canData);
+
+            if (displayedValuesDiffer(canData, lastShown))
+            {
+                lastShown = canData;
+                renderWakeup.notify();
+            }
+        } else if (count < 0) {
+            running = false;
+        }
+    }
+    canWakeSummary.publish(canWakeTracker.summary());
 }
 
-// Shift byte1 to the left by 8 bits and OR with byte2
-uint16_t concatenateBytes(uint8_t byte1, uint8_t byte2)
+// How old the data on screen is at each stage of a frame
+enum LatencyStage
 {
-    return (static_cast<uint16_t>(byte1) << 8) | byte2;
+    LATENCY_DATA_AT_RENDER, // Newest displayed value, when ImGui::Render() runs
+    LATENCY_DATA_AT_SWAP,   // Newest displayed value, once the swap/page flip returns (vsync)
+    LATENCY_RPM_AT_SWAP,    // RPM alone, what a shift light would be driven from
+    LATENCY_INPUT_AT_SWAP,  // First key press handled in a frame to that frame on screen
+    LATENCY_STAGE_COUNT
+};
+LatencyTracker latencyTrackers[LATENCY_STAGE_COUNT] = {
+    LatencyTracker("data@render"),
+    LatencyTracker("data@swap"),
+    LatencyTracker("rpm@swap"),
+    LatencyTracker("input@swap"),
+};
+
+// Records now - timestampNs for a stage, skipping channels that have never been received
+void recordLatency(LatencyStage stage, uint64_t timestampNs)
+{
+    if (timestampNs == 0)
+        return;
+
+    uint64_t now = realtimeNs();
+    latencyTrackers[stage].add(now > timestampNs ? now - timestampNs : 0);
 }
 
-void readCanData(int s, std::atomic<bool>& running, std::mutex& canDataMutex, CANBusData& canData)
+// Prints every tracker's summary, one key=value line each (F2, and at exit)
+void dumpLatency(FILE* out)
 {
-    struct can_frame frame;
+    for (LatencyTracker& tracker : latencyTrackers)
+        tracker.dump(out);
+    LatencyTracker::dump(out, canWakeTracker.name, canWakeSummary.read());
+    fflush(out);
+}
 
-    while (running) {
-        int nbytesread = read(s, &frame, sizeof(struct can_frame));
-        if (nbytesread > 0)
+// Small stats window toggled with F1
+void drawDebugOverlay(const FrameSource& source)
+{
+    static double lastSample = -1.0;
+    static uint64_t framesSeen[CAN_MAX_INTERFACES] = {};
+    static uint64_t framesAcceptedAtSample[CAN_MAX_INTERFACES] = {}; // Taken with framesSeen so the two compare
+    static int lastFrameCount = 0;
+    static double lastCpuSeconds = 0.0;
+    static double renderFps = 0.0;
+    static double cpuPercent = 0.0;
+
+    // sysfs and rusage once a second is plenty
+    double now = ImGui::GetTime();
+    if (now - lastSample >= 1.0)
+    {
+        for (size_t i = 0; i < source.inputCount() && i < CAN_MAX_INTERFACES; i++)
         {
-            if (config.civic)
-            {
-                switch (frame.can_id)
+            framesAcceptedAtSample[i] = source.inputFrames(i);
+            framesSeen[i] = source.inputFramesSeen(i);
+        }
+
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        double cpuSeconds = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+        int frameCount = ImGui::GetFrameCount();
+        if (lastSample >= 0.0)
+        {
+            renderFps = (frameCount - lastFrameCount) / (now - lastSample);
+            cpuPercent = 100.0 * (cpuSeconds - lastCpuSeconds) / (now - lastSample);
+        }
+        lastFrameCount = frameCount;
+        lastCpuSeconds = cpuSeconds;
+        lastSample = now;
+    }
+
+    uint64_t framesAccepted = canStats.framesAccepted.load(std::memory_order_relaxed);
+    uint64_t readCalls = canStats.readCalls.load(std::memory_order_relaxed);
+
+    ImGui::SetNextWindowPos(ImVec2(20, 20));
+    ImGui::SetNextWindowBgAlpha(0.8f);
+    ImGui::Begin("Debug", 0, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoInputs);
+    ImGui::SetWindowFontScale(0.5f); // 30 px from the 60 px label font
+    ImGui::Text("Source: %s, frames accepted: %llu", source.name(), (unsigned long long)framesAccepted);
+    for (size_t i = 0; i < source.inputCount() && i < CAN_MAX_INTERFACES; i++)
+    {
+        uint64_t inputAccepted = source.inputFrames(i);
+        ImGui::Text("  %s: %llu seen, %llu accepted", source.inputName(i), (unsigned long long)framesSeen[i], (unsigned long long)inputAccepted);
+        if (framesSeen[i] >= framesAcceptedAtSample[i] && framesSeen[i] > 0)
+        {
+            ImGui::SameLine();
+            ImGui::Text("(%.1f%% dropped in kernel)", 100.0 * (1.0 - (double)framesAcceptedAtSample[i] / (double)framesSeen[i]));
+        }
+    }
+    if (readCalls > 0)
+        ImGui::Text("Frames per read: %.1f", (double)framesAccepted / (double)readCalls);
+    if (sessionLogger.isRunning())
+        ImGui::Text("Log: %llu frames, %.1f MB, %llu dropped",
+            (unsigned long long)sessionLogger.writtenRecords.load(std::memory_order_relaxed),
+            sessionLogger.writtenBytes.load(std::memory_order_relaxed) / (1024.0 * 1024.0),
+            (unsigned long long)sessionLogger.droppedRecords.load(std::memory_order_relaxed));
+    ImGui::Text("Render: %.1f fps, process CPU %.1f%%%s", renderFps, cpuPercent, config.idleRender ? " (idle mode)" : "");
+
+    // Last few seconds of RPM straight out of the history ring
+    static uint64_t traceTimestamps[1024];
+    static ChannelValue traceValues[1024];
+    static float tracePlot[1024];
+    size_t traceCount = history.channels[CH_RPM].read(realtimeNs() - 5000000000ull, traceTimestamps, traceValues, 1024);
+    for (size_t i = 0; i < traceCount; i++)
+        tracePlot[i] = channelValue(traceValues[i], CH_RPM);
+    ImGui::PlotLines("##rpm", tracePlot, static_cast<int>(traceCount), 0, "RPM, 5 s", 0.0f, 9000.0f, ImVec2(600, 120));
+
+    ImGui::Separator();
+    ImGui::Text("Data age (ms)    p50    p99    max");
+    for (LatencyTracker& tracker : latencyTrackers)
+    {
+        LatencyTracker::Summary summary = tracker.summary();
+        ImGui::Text("%-12s %6.1f %6.1f %6.1f", tracker.name, summary.p50Ms, summary.p99Ms, summary.maxMs);
+    }
+    LatencyTracker::Summary canWake = canWakeSummary.read();
+    ImGui::Text("%-12s %6.2f %6.2f %6.2f", canWakeTracker.name, canWake.p50Ms, canWake.p99Ms, canWake.maxMs);
+    ImGui::End();
+}
+
+static void printUsage(const char* program)
+{
+    printf("Usage: %s [options]\n"
+           "  --vehicle=civic|mazda     Decoder profile (default civic)\n"
+           "  --dbc=PATH                Decode with signals from a DBC file instead of the profile\n"
+           "  --bind=SIG=CHANNEL[,...]  Map DBC signal names onto dash channels (e.g. EngineSpeed=rpm)\n"
+           "  --interface=NAME[,NAME]   CAN interface(s) to read (default can0)\n"
+           "  --replay=PATH             Play a candump/ASC text log or .wrdlog instead of the bus\n"
+           "  --speed=X                 Replay speed, 1 = original timing, 0 = as fast as possible\n"
+           "  --step                    Replay one frame per Space press\n"
+           "  --synthetic[=ID:HZ,...]   Generate frames in-process (default every profile ID at 100 Hz)\n"
+           "  --no-log                  Don't write a session log\n"
+           "  --can-priority=fifo:N|rr:N  Real-time priority for the CAN thread (needs CAP_SYS_NICE)\n"
+           "  --can-cpu=N               Pin the CAN thread to CPU N\n"
+           "  --render-cpu=N            Pin the render thread to CPU N\n"
+           "  --mlock                   Lock all memory at startup (mlockall)\n"
+           "  --idle / --no-idle        Redraw only when a shown value changes (default), or every frame\n"
+           "  --sdf                     Draw the readouts from a distance field font\n"
+           "  --renderer=gl2|gles2      ImGui renderer backend (default gl2)\n"
+           "  --kms[=DEVICE]            Draw straight to DRM/KMS (default /dev/dri/card0), no X11/Wayland\n"
+           "  --headless[=WxH]          Render offscreen (default 1920x1080), every frame unless --idle, needs --replay or --synthetic\n"
+           "  --frames=N                Headless: frames to render before exiting (default 1000)\n"
+           "  --frame-times=PATH        Headless: also write each frame's times to PATH as CSV\n",
+           program);
+}
+
+// Command line overrides for config; returns false if the dash shouldn't start
+static bool parseArgs(int argc, char** argv)
+{
+    static const struct option options[] = {
+        { "vehicle",   required_argument, nullptr, 'v' },
+        { "dbc",       required_argument, nullptr, 'd' },
+        { "bind",      required_argument, nullptr, 'b' },
+        { "interface", required_argument, nullptr, 'i' },
+        { "replay",    required_argument, nullptr, 'r' },
+        { "speed",     required_argument, nullptr, 's' },
+        { "step",      no_argument,       nullptr, 'S' },
+        { "synthetic", optional_argument, nullptr, 'g' },
+        { "no-log",    no_argument,       nullptr, 'n' },
+        { "can-priority", required_argument, nullptr, 'p' },
+        { "can-cpu",   required_argument, nullptr, 'c' },
+        { "render-cpu", required_argument, nullptr, 'R' },
+        { "mlock",     no_argument,       nullptr, 'm' },
+        { "idle",      no_argument,       nullptr, 'I' },
+        { "no-idle",   no_argument,       nullptr, 'P' },
+        { "sdf",       no_argument,       nullptr, 'F' },
+        { "renderer",  required_argument, nullptr, 'G' },
+        { "kms",       optional_argument, nullptr, 'K' },
+        { "headless",  optional_argument, nullptr, 'H' },
+        { "frames",    required_argument, nullptr, 'N' },
+        { "frame-times", required_argument, nullptr, 'T' },
+        { "help",      no_argument,       nullptr, 'h' },
+        { nullptr, 0, nullptr, 0 },
+    };
+
+    int option;
+    bool idleGiven = false;
+    while ((option = getopt_long(argc, argv, "h", options, nullptr)) != -1)
+    {
+        switch (option)
+        {
+            case 'v':
+                if (strcmp(optarg, "mazda") == 0)
+                    config.vehicle = VEHICLE_MAZDA;
+                else if (strcmp(optarg, "civic") == 0)
+                    config.vehicle = VEHICLE_CIVIC;
+                else
                 {
-                    case 660:
-                    case 1632:
-                        canData.rpm = static_cast<float>(concatenateBytes(frame.data[0], frame.data[1]));
-                        canData.speed = concatenateBytes(frame.data[2], frame.data[3]);
-                        canData.gear = frame.data[4];
-                        canData.voltage = static_cast<float>(frame.data[5]) / 10;
-                        break;
-                    case 661:
-                    case 1633:
-                        canData.iat = concatenateBytes(frame.data[0], frame.data[1]);
-                        canData.ect = concatenateBytes(frame.data[2], frame.data[3]);
-                        break;
-                    case 662:
-                    case 1634:
-                        canData.tps = concatenateBytes(frame.data[0], frame.data[1]);
-                        canData.map = concatenateBytes(frame.data[2], frame.data[3]) / 10;
-                        break;
-                    case 664:
-                    case 1636:
-                        canData.lambdaRatio = 32768.0f / static_cast<float>(concatenateBytes(frame.data[0], frame.data[1]));
-                        break;
-                    case 667:
-                    case 1639:
-                        //canData.oilTemp = concatenateBytes(frame.data[0], frame.data[1]);
-                        //canData.oilPressure = concatenateBytes(frame.data[2], frame.data[3]);
-                        {
-                            double oilTempResistance = concatenateBytes(frame.data[0], frame.data[1]);
-                            double kelvinTemp = 1.0 / (config.conA + config.conB * log(oilTempResistance) + config.conC * pow(log(oilTempResistance), 3));
-                            double celsiusTemp = kelvinTemp - 273.15;
-                            canData.oilTemp = celsiusTemp;
-                        }
-                        {
-                            // Calculate the ratio of the original value's position within the original range
-                            double oilPressureResistance = concatenateBytes(frame.data[2], frame.data[3]);
-                            // Use this ratio to find the equivalent position within the desired range
-                            double ratio = (oilPressureResistance - config.originalLow) / (config.originalHigh - config.originalLow);
-                            double kPaValue = (ratio * (config.desiredHigh - config.desiredLow)) + config.desiredLow;
-                            canData.oilPressure = (kPaValue * 0.145038);
-                        }                        
-                        break;
+                    fprintf(stderr, "Unknown vehicle '%s'\n", optarg);
+                    return false;
                 }
-                
-                if (canData.tps == 65535)
-                  canData.tps = 0;
-                
-                // Conversions
-                // canData.voltage = canData.voltage / 10;
-                // canData.map = canData.map / 10;
-                // canData.lambdaRatio = 32768 / canData.lambdaRatio;
-            }
-            
-            if (config.mazda) {
-                switch (frame.can_id) {
-                    case 201:
-                    case 513:
-                        std::lock_guard<std::mutex> lock(canDataMutex);
-                        canData.rpm = ((256 * frame.data[0]) + frame.data[1]) / 4;
-                        canData.tps = frame.data[6] / 2;
-                        break;
+                break;
+            case 'd':
+                config.dbcPath = optarg;
+                break;
+            case 'b':
+                config.dbcBindings = optarg;
+                break;
+            case 'i':
+                config.canInterface = optarg;
+                break;
+            case 'r':
+                config.source = SOURCE_REPLAY;
+                config.replayPath = optarg;
+                break;
+            case 's':
+                config.replaySpeed = atof(optarg);
+                break;
+            case 'S':
+                config.replayStep = true;
+                break;
+            case 'g':
+                config.source = SOURCE_SYNTHETIC;
+                config.syntheticStreams = optarg;
+                break;
+            case 'n':
+                config.logging = false;
+                break;
+            case 'p':
+                if (!parseSchedulingSpec(optarg, config.canThreadPolicy, config.canThreadPriority))
+                {
+                    fprintf(stderr, "Bad CAN thread priority '%s', expected fifo:N, rr:N or other\n", optarg);
+                    return false;
                 }
+                break;
+            case 'c':
+                config.canThreadCpu = atoi(optarg);
+                break;
+            case 'R':
+                config.renderThreadCpu = atoi(optarg);
+                break;
+            case 'm':
+                config.lockMemory = true;
+                break;
+            case 'I':
+            case 'P':
+                config.idleRender = option == 'I';
+                idleGiven = true;
+                break;
+            case 'F':
+                config.sdfValues = true;
+                break;
+            case 'G':
+                if (strcmp(optarg, "gl2") == 0)
+                    config.renderer = RENDERER_GL2;
+                else if (strcmp(optarg, "gles2") == 0)
+                    config.renderer = RENDERER_GLES2;
+                else
+                {
+                    fprintf(stderr, "Unknown renderer '%s'\n", optarg);
+                    return false;
+                }
+                break;
+            case 'K':
+#ifdef KMS_DISPLAY
+                config.display = DISPLAY_KMS;
+                if (optarg)
+                    config.kmsDevice = optarg;
+                break;
+#else
+                fprintf(stderr, "Built without KMS support, rebuild with make KMS=1\n");
+                return false;
+#endif
+            case 'H':
+                config.display = DISPLAY_HEADLESS;
+                if (optarg && sscanf(optarg, "%dx%d", &config.headlessWidth, &config.headlessHeight) != 2)
+                {
+                    fprintf(stderr, "Bad headless size '%s', expected WxH\n", optarg);
+                    return false;
+                }
+                break;
+            case 'N':
+                config.benchmarkFrames = atoi(optarg);
+                if (config.benchmarkFrames < 1)
+                {
+                    fprintf(stderr, "Bad frame count '%s'\n", optarg);
+                    return false;
+                }
+                break;
+            case 'T':
+                config.frameTimesPath = optarg;
+                break;
+            default:
+                printUsage(argv[0]);
+                return false;
+        }
+    }
+
+    if (config.display == DISPLAY_HEADLESS)
+    {
+        if (config.source == SOURCE_SOCKETCAN)
+        {
+            fprintf(stderr, "--headless needs --replay or --synthetic\n");
+            return false;
+        }
+        if (!idleGiven)
+            config.idleRender = false; // Benchmarking the render, not waiting for data
+    }
+    return true;
+}
+
+// Wall time of each startup step, printed once the first frame has been swapped so we
+// can see what stands between key-on and a readable dash
+struct StartupTimer
+{
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point last = started;
+    char steps[512] = "";
+    size_t length = 0;
+
+    void mark(const char* step)
+    {
+        auto now = std::chrono::steady_clock::now();
+        if (length < sizeof(steps))
+            length += snprintf(steps + length, sizeof(steps) - length, "%s %.1f ms, ", step, std::chrono::duration<double, std::milli>(now - last).count());
+        last = now;
+    }
+
+    // Also how long after kernel boot that was, which is the number the driver sees
+    void print() const
+    {
+        struct timespec sinceBoot;
+        clock_gettime(CLOCK_BOOTTIME, &sinceBoot);
+        printf("Startup: %stotal %.1f ms, %.1f ms since boot\n", steps, std::chrono::duration<double, std::milli>(last - started).count(),
+               sinceBoot.tv_sec * 1000.0 + sinceBoot.tv_nsec / 1e6);
+    }
+};
+
+// Headless runs: how long each frame takes to build (start of the loop to ImGui::Render()),
+// to submit (clear and RenderDrawData) and for the GPU to finish it (glFinish). One CSV line
+// per frame if asked for, percentiles over the whole run at exit.
+struct FrameBenchmark
+{
+    LatencyTracker build, submit, gpu, total;
+    FILE* csv = nullptr;
+    std::chrono::steady_clock::time_point started, built, submitted;
+
+    explicit FrameBenchmark(size_t frames)
+        : build("frame build", frames), submit("frame submit", frames), gpu("frame gpu", frames), total("frame total", frames)
+    {
+    }
+
+    void startFrame() { started = std::chrono::steady_clock::now(); }
+    void frameBuilt() { built = std::chrono::steady_clock::now(); }
+    void frameSubmitted() { submitted = std::chrono::steady_clock::now(); }
+
+    void frameFinished(int frame)
+    {
+        auto finished = std::chrono::steady_clock::now();
+        uint64_t buildNs = std::chrono::duration_cast<std::chrono::nanoseconds>(built - started).count();
+        uint64_t submitNs = std::chrono::duration_cast<std::chrono::nanoseconds>(submitted - built).count();
+        uint64_t gpuNs = std::chrono::duration_cast<std::chrono::nanoseconds>(finished - submitted).count();
+        build.add(buildNs);
+        submit.add(submitNs);
+        gpu.add(gpuNs);
+        total.add(buildNs + submitNs + gpuNs);
+        if (csv)
+            fprintf(csv, "%d,%.3f,%.3f,%.3f,%.3f\n", frame, buildNs / 1e6, submitNs / 1e6, gpuNs / 1e6, (buildNs + submitNs + gpuNs) / 1e6);
+    }
+
+    void dump(FILE* out)
+    {
+        build.dump(out);
+        submit.dump(out);
+        gpu.dump(out);
+        total.dump(out);
+        fflush(out);
+    }
+};
+
+#define LABEL_FONT_SIZE 60.0f
+#define VALUE_FONT_SIZE 100.0f
+#define LABEL_RIGHT_EDGE 623.0f // Where right-hand column labels end, as laid out for 100 px labels
+
+static ImFont* valueFont = nullptr; // Digits-only readout font, labels use the default font
+static SdfFont sdfFont;
+static bool sdfValues = false; // Readouts come from sdfFont instead of valueFont
+
+// A big readout in the value font
+static void valueText(const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    if (sdfValues)
+    {
+        char text[32];
+        vsnprintf(text, sizeof(text), format, args);
+        sdfFont.addText(ImGui::GetWindowDrawList(), ImGui::GetCursorScreenPos(), VALUE_FONT_SIZE, ImGui::GetColorU32(ImGuiCol_Text), text);
+        ImGui::Dummy(ImVec2(sdfFont.textWidth(text, VALUE_FONT_SIZE), VALUE_FONT_SIZE));
+    }
+    else
+    {
+        ImGui::PushFont(valueFont);
+        ImGui::TextV(format, args);
+        ImGui::PopFont();
+    }
+    va_end(args);
+}
+
+// Right-hand column label, right aligned so it lines up over the value whatever its width
+static void rightAlignedLabel(const char* label)
+{
+    float indent = LABEL_RIGHT_EDGE - ImGui::CalcTextSize(label).x;
+    ImGui::Indent(indent);
+    ImGui::Text("%s", label);
+    ImGui::Unindent(indent);
+}
+
+// SIGTERM (ignition cut, systemd stop) or SIGINT ends the main loop like closing the window
+static std::atomic<bool> quitRequested(false);
+
+static void requestQuit(int)
+{
+    quitRequested = true;
+}
+
+// Stops the CAN thread in bounded time: it only ever blocks inside source.receive(),
+// which interrupt() wakes, and it checks running straight after. The same sequence
+// serves for swapping the source or decoder while the dash keeps running.
+static void stopCanThread(std::thread& thread, FrameSource& source, std::atomic<bool>& running)
+{
+    auto started = std::chrono::steady_clock::now();
+    running = false;
+    source.interrupt();
+    thread.join();
+    printf("CAN thread stopped in %.1f ms\n", std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count());
+}
+
+// Builds the frame source config asks for. replaySource is set when it is a replay,
+// so the render loop can drive single-stepping. profileIds are the IDs the active
+// decoder understands, used for the bus filter and the default synthetic streams.
+static std::unique_ptr<FrameSource> createFrameSource(const std::vector<canid_t>& profileIds, ReplaySource*& replaySource)
+{
+    replaySource = nullptr;
+
+    switch (config.source)
+    {
+        case SOURCE_REPLAY:
+        {
+            // Recorded session instead of the car
+            std::unique_ptr<ReplaySource> replay(new ReplaySource());
+            if (!config.replayPath || !replay->open(config.replayPath))
+                return nullptr;
+            replay->setSpeed(config.replaySpeed);
+            replay->setStepping(config.replayStep);
+            replaySource = replay.get();
+            return replay;
+        }
+        case SOURCE_SYNTHETIC:
+        {
+            std::vector<SyntheticSource::Stream> streams;
+            if (config.syntheticStreams)
+            {
+                if (!SyntheticSource::parseStreams(config.syntheticStreams, streams))
+                {
+                    fprintf(stderr, "Bad synthetic stream list '%s', expected ID:HZ,ID:HZ\n", config.syntheticStreams);
+                    return nullptr;
+                }
+            } else {
+                for (canid_t id : profileIds)
+                    streams.push_back({ id, config.syntheticRateHz });
             }
-        } else if (nbytesread < 0) {
-            perror("can raw socket read");
-            running = false;
+            return std::unique_ptr<FrameSource>(new SyntheticSource(streams));
+        }
+        case SOURCE_SOCKETCAN:
+        default:
+        {
+            std::unique_ptr<SocketCanSource> socketSource(new SocketCanSource());
+            if (!socketSource->open(config.canInterface, profileIds))
+                return nullptr;
+            return socketSource;
         }
     }
 }
 
-int main(int, char**)
+// ----------------------------- Display (GLFW window, KMS or headless) -----------------------------
+// main() goes through these so the loop is the same whichever one config.display picked
+static GLFWwindow* window = nullptr;
+static bool displayFailed = false; // The display went away under us, main() exits with an error
+static uint64_t glfwKeyNs = 0; // When GLFW handed us the first key of this frame, 0 if none
+#ifdef KMS_DISPLAY
+#define KMS_MAX_SWAP_FAILURES 10     // Failed frames in a row before the display counts as lost
+#define KMS_SWAP_BACKOFF_US 100000   // Wait after the nth failure is n times this, ~4.5 s in all
+static int kmsSwapFailures = 0;
+#endif
+
+static void glfwKeyCallback(GLFWwindow*, int, int, int action, int)
 {
+    // Only from when GLFW dispatches it, the X server/compositor's share isn't visible from here
+    if (action == GLFW_PRESS && glfwKeyNs == 0)
+        glfwKeyNs = realtimeNs();
+}
+
+// Brings up the output and makes its GL context current
+static bool openDisplay(StartupTimer& startup)
+{
+#ifdef KMS_DISPLAY
+    if (config.display == DISPLAY_KMS)
+    {
+        if (!ImGui_ImplKms_CreateDisplay(config.kmsDevice))
+            return false;
+        startup.mark("kms+context");
+        return true;
+    }
+#endif
+    if (config.display == DISPLAY_HEADLESS)
+    {
+        if (!createHeadlessContext(config.headlessWidth, config.headlessHeight))
+            return false;
+        startup.mark("headless context");
+        return true;
+    }
+
     glfwSetErrorCallback(glfw_error_callback);
     if (!glfwInit())
-        return 1;
+        return false;
+    startup.mark("glfw init");
 
-    // --------------------------------------- Window setup ---------------------------------------
     GLFWmonitor* primaryMonitor = glfwGetPrimaryMonitor();
     if (!primaryMonitor)
     {
         glfwTerminate();
-        return -1;
+        return false;
     }
 
     // Get the video mode of the primary monitor
@@ -187,18 +689,195 @@ int main(int, char**)
     glfwWindowHint(GLFW_REFRESH_RATE, mode->refreshRate);
 
     // Create window with graphics context
-    // GLFWwindow* window = glfwCreateWindow(1920, 1080, "Wills Race Dash", nullptr, nullptr);
-    GLFWwindow* window = glfwCreateWindow(mode->width, mode->height, "Wills Race Dash", primaryMonitor, nullptr);
+    // window = glfwCreateWindow(1920, 1080, "Wills Race Dash", nullptr, nullptr);
+    window = glfwCreateWindow(mode->width, mode->height, "Wills Race Dash", primaryMonitor, nullptr);
     if (window == nullptr)
     {
         glfwTerminate();
-        return 1;
+        return false;
     }
 
-    // --------------------------------------------------------------------------------------------
-
     glfwMakeContextCurrent(window);
     glfwSwapInterval(1); // Enable vsync
+    startup.mark("window+context");
+    return true;
+}
+
+static void initPlatformBackend()
+{
+#ifdef KMS_DISPLAY
+    if (config.display == DISPLAY_KMS)
+    {
+        ImGui_ImplKms_Init();
+        renderWakeup.wake = ImGui_ImplKms_PostEmptyEvent;
+        return;
+    }
+#endif
+    if (config.display == DISPLAY_HEADLESS)
+    {
+        ImGui::GetIO().BackendPlatformName = "headless";
+        renderWakeup.wake = headlessPostEmptyEvent;
+        return;
+    }
+    glfwSetKeyCallback(window, glfwKeyCallback); // Installed first so the ImGui backend chains to it
+    ImGui_ImplGlfw_InitForOpenGL(window, true);
+    renderWakeup.wake = glfwPostEmptyEvent;
+}
+
+static bool displayClosed()
+{
+#ifdef KMS_DISPLAY
+    if (config.display == DISPLAY_KMS)
+        return displayFailed; // Nothing to close, only signals or a lost display end it
+#endif
+    if (config.display == DISPLAY_HEADLESS)
+        return ImGui::GetFrameCount() >= config.benchmarkFrames;
+    return glfwWindowShouldClose(window);
+}
+
+// Sleeps for input, a wakeup or timeoutSeconds; 0 only handles what's already queued
+static void waitDisplayEvents(double timeoutSeconds)
+{
+#ifdef KMS_DISPLAY
+    if (config.display == DISPLAY_KMS)
+    {
+        ImGui_ImplKms_WaitEvents(timeoutSeconds);
+        return;
+    }
+#endif
+    if (config.display == DISPLAY_HEADLESS)
+    {
+        headlessWaitEvents(timeoutSeconds);
+        return;
+    }
+    if (timeoutSeconds > 0.0)
+        glfwWaitEventsTimeout(timeoutSeconds);
+    else
+        glfwPollEvents();
+}
+
+static void platformNewFrame()
+{
+#ifdef KMS_DISPLAY
+    if (config.display == DISPLAY_KMS)
+    {
+        ImGui_ImplKms_NewFrame();
+        return;
+    }
+#endif
+    if (config.display == DISPLAY_HEADLESS)
+    {
+        // Real elapsed time, so anything animated runs at the speed it would on screen
+        static auto last = std::chrono::steady_clock::now();
+        auto now = std::chrono::steady_clock::now();
+        ImGuiIO& io = ImGui::GetIO();
+        io.DisplaySize = ImVec2((float)config.headlessWidth, (float)config.headlessHeight);
+        io.DeltaTime = std::max(std::chrono::duration<float>(now - last).count(), 1e-6f);
+        last = now;
+        return;
+    }
+    ImGui_ImplGlfw_NewFrame();
+}
+
+static void displaySize(int* width, int* height)
+{
+#ifdef KMS_DISPLAY
+    if (config.display == DISPLAY_KMS)
+    {
+        ImGui_ImplKms_GetDisplaySize(width, height);
+        return;
+    }
+#endif
+    if (config.display == DISPLAY_HEADLESS)
+    {
+        *width = config.headlessWidth;
+        *height = config.headlessHeight;
+        return;
+    }
+    glfwGetFramebufferSize(window, width, height);
+}
+
+// Returns once the frame is on screen (vsync), with the time of the first key press it answers, 0 if none
+static uint64_t swapDisplay()
+{
+#ifdef KMS_DISPLAY
+    if (config.display == DISPLAY_KMS)
+    {
+        if (ImGui_ImplKms_SwapBuffers())
+            kmsSwapFailures = 0;
+        else
+        {
+            // Usually another process took DRM master (a VT switch, a compositor starting):
+            // back off in case it hands the display back, give up rather than spin if not
+            kmsSwapFailures++;
+            fprintf(stderr, "KMS: frame not shown, %d failure%s in a row\n", kmsSwapFailures, kmsSwapFailures > 1 ? "s" : "");
+            if (kmsSwapFailures >= KMS_MAX_SWAP_FAILURES)
+            {
+                fprintf(stderr, "KMS: display lost, exiting\n");
+                displayFailed = true;
+            }
+            else
+                usleep(KMS_SWAP_BACKOFF_US * kmsSwapFailures);
+        }
+        return ImGui_ImplKms_ConsumeInputTimestamp();
+    }
+#endif
+    if (config.display == DISPLAY_HEADLESS)
+    {
+        glFinish(); // Nothing to show, wait for the GPU instead so frames can't queue up
+        return 0;
+    }
+    glfwMakeContextCurrent(window);
+    glfwSwapBuffers(window);
+    uint64_t keyNs = glfwKeyNs;
+    glfwKeyNs = 0;
+    return keyNs;
+}
+
+static void closeDisplay()
+{
+#ifdef KMS_DISPLAY
+    if (config.display == DISPLAY_KMS)
+    {
+        ImGui_ImplKms_Shutdown();
+        ImGui::DestroyContext();
+        ImGui_ImplKms_DestroyDisplay();
+        return;
+    }
+#endif
+    if (config.display == DISPLAY_HEADLESS)
+    {
+        ImGui::DestroyContext();
+        destroyHeadlessContext();
+        return;
+    }
+    ImGui_ImplGlfw_Shutdown();
+    ImGui::DestroyContext();
+    glfwDestroyWindow(window);
+    glfwTerminate();
+}
+
+// Renderer backend, GL objects and then the display, for every exit after openDisplay()
+// so KMS gets its CRTC back even when startup fails
+static void closeRenderer()
+{
+    sdfFont.destroyDeviceObjects();
+    if (config.renderer == RENDERER_GLES2)
+        ImGui_ImplGLES2_Shutdown();
+    else
+        ImGui_ImplOpenGL2_Shutdown();
+    closeDisplay();
+}
+// --------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    StartupTimer startup;
+    if (!parseArgs(argc, argv))
+        return 1;
+
+    if (!openDisplay(startup))
+        return 1;
 
     // Setup Dear ImGui context
     IMGUI_CHECKVERSION();
@@ -210,70 +889,199 @@ int main(int, char**)
     ImGui::StyleColorsDark();
 
     // Setup Platform/Renderer backends
-    ImGui_ImplGlfw_InitForOpenGL(window, true);
-    ImGui_ImplOpenGL2_Init();
+    initPlatformBackend();
+    if (config.renderer == RENDERER_GLES2)
+    {
+        ImGui_ImplGLES2_Init();
+        if (!ImGui_ImplGLES2_CreateDeviceObjects())
+        {
+            closeRenderer();
+            return 1;
+        }
+    }
+    else
+        ImGui_ImplOpenGL2_Init();
+    printf("Renderer: %s\n", io.BackendRendererName);
+
+    startup.mark("imgui init");
+
+    // Load Fonts, from the baked atlas cache after the first boot
+    // Labels (and everything else ImGui draws) use a small ASCII font; the big readouts
+    // get their own atlas entry holding only what a number can contain
+    static const ImWchar labelGlyphs[] = { 0x0020, 0x007E, 0 };
+    static const ImWchar valueGlyphs[] = {
+        0x0020, 0x0020, // Space
+        0x0025, 0x0025, // %
+        0x002D, 0x003A, // - . / 0-9 :
+        0x003F, 0x003F, // ? (fallback)
+        0,
+    };
+
+    // With --sdf the readouts come from one small distance field atlas and the bitmap
+    // atlas only holds the labels. Falls back to the bitmap readout font if the shader fails.
+    // imgui_impl_gles2 has the distance field shader built in, GL2 needs ours.
+    if (config.sdfValues)
+    {
+        bool sdfFromCache = false;
+        bool backendShader = config.renderer == RENDERER_GLES2;
+        sdfValues = sdfFont.load(".././assets/Calibri.ttf", valueGlyphs, config.fontCacheDirectory, sdfFromCache)
+            && sdfFont.createDeviceObjects(!backendShader)
+            && (!backendShader || ImGui_ImplGLES2_SetDistanceFieldTexture(sdfFont.textureId()));
+        if (sdfValues)
+            printf("SDF atlas: %dx%d Alpha8, %d KiB\n", sdfFont.atlasWidth(), sdfFont.atlasHeight(), sdfFont.atlasWidth() * sdfFont.atlasHeight() / 1024);
+        else
+            fprintf(stderr, "SDF readouts unavailable, using the bitmap font\n");
+        startup.mark(sdfFromCache ? "sdf font (cached)" : "sdf font (baked)");
+    }
 
-    // Load Fonts
-    io.Fonts->AddFontFromFileTTF(".././assets/Calibri.ttf", 100.0f, NULL, io.Fonts->GetGlyphRangesDefault());
+    const FontSpec fonts[] = {
+        { ".././assets/Calibri.ttf", LABEL_FONT_SIZE, labelGlyphs },
+        { ".././assets/Calibri.ttf", VALUE_FONT_SIZE, valueGlyphs },
+    };
+    bool fontsFromCache = false;
+    if (!loadFontsCached(io.Fonts, fonts, sdfValues ? 1 : IM_ARRAYSIZE(fonts), config.fontCacheDirectory, fontsFromCache))
+    {
+        closeRenderer();
+        return 1;
+    }
+    valueFont = sdfValues ? nullptr : io.Fonts->Fonts[1];
+    printf("Font atlas: %dx%d Alpha8, %d KiB\n", io.Fonts->TexWidth, io.Fonts->TexHeight, io.Fonts->TexWidth * io.Fonts->TexHeight / 1024);
     //io.Fonts->AddFontFromFileTTF("C:\\Windows\\Fonts\\Candara.ttf", 60.0f, NULL, io.Fonts->GetGlyphRangesDefault());
+    startup.mark(fontsFromCache ? "fonts (cached)" : "fonts (baked)");
+
+    // Upload now rather than inside the first NewFrame() so it shows up on its own
+    if (config.renderer == RENDERER_GLES2)
+        ImGui_ImplGLES2_CreateFontsTexture();
+    else
+        ImGui_ImplOpenGL2_CreateFontsTexture();
+    startup.mark("font texture");
 
     // Our state
     ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
 
     // ------------------------------ CANBus setup ------------------------------
-    int s;
-    struct can_frame frame;
-    struct sockaddr_can addr;
-    struct ifreq ifr;
-
-    // Create socket
-    if ((s = socket(PF_CAN, SOCK_RAW, CAN_RAW)) < 0) {
-       fprintf(stderr, "Socket creation failed\n");
-       // return;
+    // A DBC file replaces the built-in profile for decoding
+    DbcDecoder dbcDecoder;
+    if (config.dbcPath && !dbcDecoder.load(config.dbcPath, config.dbcBindings))
+    {
+        closeRenderer();
+        return 1;
     }
 
-    // Interface setup
-    strcpy(ifr.ifr_name, CAN_INTERFACE);
-    ioctl(s, SIOCGIFINDEX, &ifr);
+    std::vector<canid_t> profileIds = config.dbcPath ? dbcDecoder.canIds()
+        : config.vehicle == VEHICLE_MAZDA ? ProfileDecoder<MazdaProfile>().canIds() : ProfileDecoder<CivicProfile>().canIds();
 
-    addr.can_family = AF_CAN;
-    addr.can_ifindex = ifr.ifr_ifindex;
+    // Units the stored values are in, only used by fixed point builds
+    channelScales = config.dbcPath ? dbcDecoder.channelScales()
+        : config.vehicle == VEHICLE_MAZDA ? ProfileDecoder<MazdaProfile>().channelScales() : ProfileDecoder<CivicProfile>().channelScales();
 
-    // Bind socket to CAN interface
-    if (bind(s, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
-       perror("Binding failed");
-       close(s);
-       // return;
+    ReplaySource* replaySource = nullptr;
+    std::unique_ptr<FrameSource> source = createFrameSource(profileIds, replaySource);
+    if (!source)
+    {
+        closeRenderer();
+        return 1;
     }
+    printf("Reading frames from %s\n", source->name());
     // --------------------------------------------------------------------------
-    CANBusData canData;
+    // Oil temp curve, must exist before the first frame is decoded
+    thermistorTable.build(config.conA, config.conB, config.conC);
+
+    // Locked before the big allocations below so they are faulted in now, not on first use
+    if (config.lockMemory)
+        lockProcessMemory();
+
+    // All history memory is allocated here, the CAN thread only ever appends
+    history.init(config.historyBytesPerChannel);
+
+    // Latest decoded values, written by the CAN thread and read once per frame here
+    SnapshotBuffer<CANBusData> canSnapshot;
 
     // Atomic flag for controlling threads
     std::atomic<bool> running(true);
 
-    // Mutex for synchronizing access to canData
-    std::mutex canDataMutex;
+    // Session log, named after the local start time
+    SessionLogger* logger = nullptr;
+    if (config.logging && config.source == SOURCE_SOCKETCAN)
+    {
+        char logPath[256];
+        time_t startTime = time(nullptr);
+        struct tm localStart;
+        localtime_r(&startTime, &localStart);
+        mkdir(config.logDirectory, 0755);
+        size_t length = snprintf(logPath, sizeof(logPath), "%s/session-", config.logDirectory);
+        strftime(logPath + length, sizeof(logPath) - length, "%Y%m%d-%H%M%S.wrdlog", &localStart);
 
-    // Create a thread for reading CAN data
-    std::thread canReaderThread(readCanData, s, std::ref(running), std::ref(canDataMutex), std::ref(canData));
+        const char* profileName = config.dbcPath ? dbcDecoder.name()
+            : config.vehicle == VEHICLE_MAZDA ? MazdaProfile::name : CivicProfile::name;
+        if (sessionLogger.start(logPath, profileName, config.logFlushIntervalMs))
+        {
+            logger = &sessionLogger;
+            printf("Logging session to %s\n", logPath);
+        }
+    }
+
+    // Create a thread for reading CAN data, with the decoder for the configured vehicle baked in
+    std::thread canReaderThread;
+    if (config.dbcPath)
+        canReaderThread = std::thread(readCanData<DbcDecoder>, std::cref(dbcDecoder), std::ref(*source), std::ref(running), std::ref(canSnapshot), std::ref(history), logger);
+    else if (config.vehicle == VEHICLE_MAZDA)
+        canReaderThread = std::thread(readCanData<ProfileDecoder<MazdaProfile>>, ProfileDecoder<MazdaProfile>(), std::ref(*source), std::ref(running), std::ref(canSnapshot), std::ref(history), logger);
+    else
+        canReaderThread = std::thread(readCanData<ProfileDecoder<CivicProfile>>, ProfileDecoder<CivicProfile>(), std::ref(*source), std::ref(running), std::ref(canSnapshot), std::ref(history), logger);
+
+    // Scheduling for both threads, pinned after the CAN thread exists so it doesn't inherit the render CPU
+    configureThread(canReaderThread.native_handle(), "CAN", config.canThreadPolicy, config.canThreadPriority, config.canThreadCpu);
+    configureThread(pthread_self(), "Render", SCHED_POLICY_OTHER, 0, config.renderThreadCpu);
     // --------------------------------------------------------------------------
 
+    startup.mark("can setup");
+
     // Main loop
-    while (!glfwWindowShouldClose(window))
+    // In idle mode the CAN thread posts an empty event (renderWakeup.wake) to wake us when a shown value changes
+
+    struct sigaction quitAction;
+    memset(&quitAction, 0, sizeof(quitAction));
+    quitAction.sa_handler = requestQuit;
+    sigaction(SIGTERM, &quitAction, nullptr);
+    sigaction(SIGINT, &quitAction, nullptr);
+
+    FrameBenchmark benchmark(config.display == DISPLAY_HEADLESS ? config.benchmarkFrames : 1);
+    if (config.display == DISPLAY_HEADLESS && config.frameTimesPath)
     {
-        glfwPollEvents();
+        benchmark.csv = fopen(config.frameTimesPath, "w");
+        if (!benchmark.csv)
+            perror(config.frameTimesPath);
+        else
+            fprintf(benchmark.csv, "frame,build_ms,submit_ms,gpu_ms,total_ms\n");
+    }
+
+    // An idle loop notices quitRequested at the next wakeup, at most idleRefreshSeconds
+    while (!displayClosed() && !quitRequested)
+    {
+        waitDisplayEvents(config.idleRender ? config.idleRefreshSeconds : 0.0); // Idle: data change, input or refresh deadline
+        renderWakeup.clear();
+        benchmark.startFrame();
+
         // Start the Dear ImGui frame
-        ImGui_ImplOpenGL2_NewFrame();
-        ImGui_ImplGlfw_NewFrame();
+        if (config.renderer == RENDERER_GLES2)
+            ImGui_ImplGLES2_NewFrame();
+        else
+            ImGui_ImplOpenGL2_NewFrame();
+        platformNewFrame();
         ImGui::NewFrame();
         ImGui::SetNextWindowPos(ImVec2(0, 0));
         ImGui::SetNextWindowSize(ImVec2(1920, 1080));
         static float min_row_height = 150.0f;
         static float middle_column_indent = 180.0f;
 
+        // One coherent copy of the CAN values for this whole frame
+        const CANBusData canData = canSnapshot.read();
+        uint64_t newestTimestampNs = *std::max_element(canData.timestampNs, canData.timestampNs + CH_COUNT);
+
         // ===============================================================================================================
         ImGui::Begin("Wills Race Dash", 0, ImGuiWindowFlags_NoDecoration);
-        ImGui::ProgressBar(canData.rpm / 9000.0f, ImVec2(1905, 100), "");
+        ImGui::ProgressBar(channelValue(canData, CH_RPM) / 9000.0f, ImVec2(1905, 100), "");
         
         // ImGuiTableFlags_BordersInnerH | ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg
         if (ImGui::BeginTable("Data Table", 3,  ImGuiTableFlags_BordersInnerH))
@@ -286,20 +1094,18 @@ int main(int, char**)
             ImGui::Text("RPM:");
             ImGui::Unindent(middle_column_indent);
             ImGui::TableNextColumn();
-            ImGui::Indent(230.0f);
-            ImGui::Text("Oil Temp:");
-            ImGui::Unindent(230.0f);
+            rightAlignedLabel("Oil Temp:");
             //float textWidth1 = ImGui::CalcTextSize("Oil Temp:").x;
             ImGui::TableNextRow(ImGuiTableRowFlags_None, min_row_height);
             ImGui::TableNextColumn();
-            ImGui::Text("%d", canData.ect);
+            valueText("%.0f", channelValue(canData, CH_ECT));
             ImGui::TableNextColumn();
             ImGui::Indent(middle_column_indent);
-            ImGui::Text("%.0f", canData.rpm);
+            valueText("%.0f", channelValue(canData, CH_RPM));
             ImGui::Unindent(middle_column_indent);
             ImGui::TableNextColumn();
             ImGui::Indent(460.0f);
-            ImGui::Text("%.0f", canData.oilTemp);
+            valueText("%.0f", channelValue(canData, CH_OIL_TEMP));
             ImGui::Unindent(460.0f);
 
             ImGui::TableNextRow();
@@ -310,19 +1116,17 @@ int main(int, char**)
             ImGui::Text("Speed:");
             ImGui::Unindent(middle_column_indent);
             ImGui::TableNextColumn();
-            ImGui::Indent(110.0f);
-            ImGui::Text("Oil Pressure:");
-            ImGui::Unindent(110.0f);
+            rightAlignedLabel("Oil Pressure:");
             ImGui::TableNextRow(ImGuiTableRowFlags_None, min_row_height);
             ImGui::TableNextColumn();
-            ImGui::Text("%d", canData.iat);
+            valueText("%.0f", channelValue(canData, CH_IAT));
             ImGui::TableNextColumn();
             ImGui::Indent(middle_column_indent);
-            ImGui::Text("%d", canData.speed);
+            valueText("%.0f", channelValue(canData, CH_SPEED));
             ImGui::Unindent(middle_column_indent);
             ImGui::TableNextColumn();
             ImGui::Indent(460.0f);
-            ImGui::Text("%.0f", canData.oilPressure);
+            valueText("%.0f", channelValue(canData, CH_OIL_PRESSURE));
             ImGui::Unindent(460.0f);
 
             ImGui::TableNextRow();
@@ -333,19 +1137,17 @@ int main(int, char**)
             ImGui::Text("Gear:");
             ImGui::Unindent(middle_column_indent);
             ImGui::TableNextColumn();
-            ImGui::Indent(450.0f);
-            ImGui::Text("TPS:");
-            ImGui::Unindent(450.0f);
+            rightAlignedLabel("TPS:");
             ImGui::TableNextRow(ImGuiTableRowFlags_None, min_row_height);
             ImGui::TableNextColumn();
-            ImGui::Text("%d", canData.map);
+            valueText("%.0f", channelValue(canData, CH_MAP));
             ImGui::TableNextColumn();
             ImGui::Indent(middle_column_indent);
-            ImGui::Text("%d", canData.gear);
+            valueText("%.0f", channelValue(canData, CH_GEAR));
             ImGui::Unindent(middle_column_indent);
             ImGui::TableNextColumn();
             ImGui::Indent(460.0f);
-            ImGui::Text("%d", canData.tps);
+            valueText("%.0f", channelValue(canData, CH_TPS));
             ImGui::Unindent(460.0f);
 
             ImGui::TableNextRow();
@@ -353,56 +1155,83 @@ int main(int, char**)
             ImGui::Text("Air/Fuel:");
             ImGui::TableNextColumn();
             ImGui::Indent(middle_column_indent);
-            ImGui::Text("-");
+            valueText("-");
             ImGui::Unindent(middle_column_indent);
             ImGui::TableNextColumn();
-            ImGui::Indent(290.0f);
-            ImGui::Text("Voltage:");
-            ImGui::Unindent(290.0f);
+            rightAlignedLabel("Voltage:");
             ImGui::TableNextRow(ImGuiTableRowFlags_None, min_row_height);
             ImGui::TableNextColumn();
-            ImGui::Text("%.1f", canData.lambdaRatio);
+            valueText("%.1f", channelValue(canData, CH_LAMBDA));
             ImGui::TableNextColumn();
             ImGui::Indent(middle_column_indent);
-            ImGui::Text("-");
+            valueText("-");
             ImGui::Unindent(middle_column_indent);
             ImGui::TableNextColumn();
             ImGui::Indent(440.0f);
-            ImGui::Text("%.1f", canData.voltage);
+            valueText("%.1f", channelValue(canData, CH_VOLTAGE));
             ImGui::Unindent(440.0f);
 
             ImGui::EndTable();
         }
 
         ImGui::End();
+
+        static bool showDebugOverlay = false;
+        if (ImGui::IsKeyPressed(ImGuiKey_F1))
+            showDebugOverlay = !showDebugOverlay;
+        if (showDebugOverlay)
+            drawDebugOverlay(*source);
+        if (ImGui::IsKeyPressed(ImGuiKey_F2))
+            dumpLatency(stdout);
+        if (replaySource && replaySource->isStepping() && ImGui::IsKeyPressed(ImGuiKey_Space))
+            replaySource->step();
         // ===============================================================================================================
 
         // Rendering
+        recordLatency(LATENCY_DATA_AT_RENDER, newestTimestampNs);
         ImGui::Render();
+        benchmark.frameBuilt();
         int display_w, display_h;
-        glfwGetFramebufferSize(window, &display_w, &display_h);
+        displaySize(&display_w, &display_h);
         glViewport(0, 0, display_w, display_h);
         glClearColor(clear_color.x * clear_color.w, clear_color.y * clear_color.w, clear_color.z * clear_color.w, clear_color.w);
         glClear(GL_COLOR_BUFFER_BIT);
 
-        ImGui_ImplOpenGL2_RenderDrawData(ImGui::GetDrawData());
+        if (config.renderer == RENDERER_GLES2)
+            ImGui_ImplGLES2_RenderDrawData(ImGui::GetDrawData());
+        else
+            ImGui_ImplOpenGL2_RenderDrawData(ImGui::GetDrawData());
+        benchmark.frameSubmitted();
 
-        glfwMakeContextCurrent(window);
-        glfwSwapBuffers(window);
+        uint64_t inputTimestampNs = swapDisplay();
+        recordLatency(LATENCY_DATA_AT_SWAP, newestTimestampNs);
+        recordLatency(LATENCY_RPM_AT_SWAP, canData.timestampNs[CH_RPM]);
+        recordLatency(LATENCY_INPUT_AT_SWAP, inputTimestampNs);
+        if (config.display == DISPLAY_HEADLESS)
+            benchmark.frameFinished(ImGui::GetFrameCount());
+
+        if (ImGui::GetFrameCount() == 1)
+        {
+            startup.mark("first frame");
+            startup.print();
+        }
     }
 
-    canReaderThread.join();
+    stopCanThread(canReaderThread, *source, running);
+    sessionLogger.stop();
+    dumpLatency(stdout);
+    if (config.display == DISPLAY_HEADLESS)
+    {
+        benchmark.dump(stdout);
+        if (benchmark.csv)
+            fclose(benchmark.csv);
+    }
 
     // Cleanup
-    ImGui_ImplOpenGL2_Shutdown();
-    ImGui_ImplGlfw_Shutdown();
-    ImGui::DestroyContext();
-
-    glfwDestroyWindow(window);
-    glfwTerminate();
+    closeRenderer();
 
     // Close CANBus socket
-    close(s);
+    source.reset();
 
-    return 0;
+    return displayFailed ? 1 : 0;
 }
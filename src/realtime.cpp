@@ -0,0 +1,96 @@
+#include "realtime.h"
+
+#include <errno.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+bool parseSchedulingSpec(const char* spec, SchedulingPolicy& policy, int& priority)
+{
+    if (strcmp(spec, "other") == 0)
+    {
+        policy = SCHED_POLICY_OTHER;
+        priority = 0;
+        return true;
+    }
+
+    if (strncmp(spec, "fifo:", 5) == 0)
+        policy = SCHED_POLICY_FIFO;
+    else if (strncmp(spec, "rr:", 3) == 0)
+        policy = SCHED_POLICY_RR;
+    else
+        return false;
+
+    char* end;
+    long value = strtol(strchr(spec, ':') + 1, &end, 10);
+    if (*end || value < sched_get_priority_min(SCHED_FIFO) || value > sched_get_priority_max(SCHED_FIFO))
+        return false;
+    priority = static_cast<int>(value);
+    return true;
+}
+
+static const char* policyName(int policy)
+{
+    switch (policy)
+    {
+        case SCHED_FIFO:
+            return "SCHED_FIFO";
+        case SCHED_RR:
+            return "SCHED_RR";
+        case SCHED_OTHER:
+            return "SCHED_OTHER";
+        default:
+            return "other";
+    }
+}
+
+void configureThread(pthread_t thread, const char* label, SchedulingPolicy policy, int priority, int cpu)
+{
+    if (policy != SCHED_POLICY_OTHER)
+    {
+        struct sched_param param = {};
+        param.sched_priority = priority;
+        int error = pthread_setschedparam(thread, policy == SCHED_POLICY_FIFO ? SCHED_FIFO : SCHED_RR, &param);
+        if (error)
+            fprintf(stderr, "%s thread: can't set real-time priority: %s\n", label, strerror(error));
+    }
+
+    if (cpu >= 0)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(cpu, &cpus);
+        int error = pthread_setaffinity_np(thread, sizeof(cpus), &cpus);
+        if (error)
+            fprintf(stderr, "%s thread: can't pin to CPU %d: %s\n", label, cpu, strerror(error));
+    }
+
+    // Report what took effect rather than what was asked for
+    int effectivePolicy;
+    struct sched_param effectiveParam;
+    pthread_getschedparam(thread, &effectivePolicy, &effectiveParam);
+
+    char cpuList[128] = "";
+    cpu_set_t effectiveCpus;
+    if (pthread_getaffinity_np(thread, sizeof(effectiveCpus), &effectiveCpus) == 0)
+    {
+        size_t length = 0;
+        for (int i = 0; i < CPU_SETSIZE && length < sizeof(cpuList) - 8; i++)
+            if (CPU_ISSET(i, &effectiveCpus))
+                length += snprintf(cpuList + length, sizeof(cpuList) - length, length ? ",%d" : "%d", i);
+    }
+    printf("%s thread: %s priority %d, CPUs %s\n", label, policyName(effectivePolicy), effectiveParam.sched_priority, cpuList);
+}
+
+bool lockProcessMemory()
+{
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+    {
+        fprintf(stderr, "mlockall failed: %s\n", strerror(errno));
+        return false;
+    }
+    printf("Memory locked (mlockall)\n");
+    return true;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <pthread.h>
+
+#include "config.h"
+
+// "fifo:50", "rr:10" or "other" -> policy and priority. Returns false on a malformed spec.
+bool parseSchedulingSpec(const char* spec, SchedulingPolicy& policy, int& priority);
+
+// Applies a scheduling policy/priority (skipped for SCHED_POLICY_OTHER) and pins the
+// thread to cpu (skipped if cpu < 0), then prints what the thread actually ended up
+// with, since both need privileges the dash may not have.
+void configureThread(pthread_t thread, const char* label, SchedulingPolicy policy, int priority, int cpu);
+
+// mlockall() so the CAN thread never stalls on a page fault; prints the outcome
+bool lockProcessMemory();
@@ -0,0 +1,331 @@
+#include "replay_source.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "timestamp.h"
+
+#define REPLAY_MAX_WAIT std::chrono::milliseconds(100) // Longest receive() sleeps before returning 0
+
+// Parses "DEADBEEF" style payloads (no separators) into record.data
+static bool parseCompactPayload(const char* hex, LogRecord& record)
+{
+    size_t length = strlen(hex);
+    if (length % 2 != 0 || length > 16)
+        return false;
+
+    record.dlc = static_cast<uint8_t>(length / 2);
+    for (size_t i = 0; i < record.dlc; i++)
+    {
+        char byte[3] = { hex[i * 2], hex[i * 2 + 1], 0 };
+        if (!isxdigit(byte[0]) || !isxdigit(byte[1]))
+            return false;
+        record.data[i] = static_cast<uint8_t>(strtoul(byte, nullptr, 16));
+    }
+    return true;
+}
+
+// "123" is a standard ID, anything longer than 3 hex digits is extended
+static uint32_t parseCanId(const char* text, size_t digits)
+{
+    uint32_t id = static_cast<uint32_t>(strtoul(text, nullptr, 16));
+    return digits > 3 ? (id & CAN_EFF_MASK) | CAN_EFF_FLAG : id;
+}
+
+// candump -l / -L:  (1436509052.249713) can0 123#DEADBEEF
+// candump -ta:      (1436509052.249713)  can0  123   [4]  DE AD BE EF
+static bool parseCandumpLine(const char* line, LogRecord& record)
+{
+    unsigned long long seconds = 0;
+    char fraction[16], iface[32], frame[64];
+    int consumed = 0;
+    if (sscanf(line, " (%llu.%15[0-9]) %31s %63s%n", &seconds, fraction, iface, frame, &consumed) != 4)
+        return false;
+
+    // Fraction may be micro or nanoseconds depending on the candump version
+    uint64_t fractionNs = strtoull(fraction, nullptr, 10);
+    for (size_t digits = strlen(fraction); digits < 9; digits++)
+        fractionNs *= 10;
+    record.timestampNs = seconds * 1000000000ull + fractionNs;
+
+    const char* hash = strchr(frame, '#');
+    if (hash)
+    {
+        if (hash[1] == '#')
+            return false; // CAN FD, never on the dash's buses
+        record.canId = parseCanId(frame, hash - frame);
+        if (hash[1] == 'R')
+        {
+            record.canId |= CAN_RTR_FLAG;
+            record.dlc = 0;
+            return true;
+        }
+        return parseCompactPayload(hash + 1, record);
+    }
+
+    // Spaced form: ID then [dlc] then bytes
+    record.canId = parseCanId(frame, strlen(frame));
+    const char* rest = line + consumed;
+    unsigned dlc = 0;
+    int offset = 0;
+    if (sscanf(rest, " [%u]%n", &dlc, &offset) != 1 || dlc > 8)
+        return false;
+    rest += offset;
+
+    record.dlc = static_cast<uint8_t>(dlc);
+    for (unsigned i = 0; i < dlc; i++)
+    {
+        unsigned byte;
+        if (sscanf(rest, " %2x%n", &byte, &offset) != 1)
+            return false;
+        record.data[i] = static_cast<uint8_t>(byte);
+        rest += offset;
+    }
+    return true;
+}
+
+// Vector ASC:   0.010000 1  123             Rx   d 8 01 02 03 04 05 06 07 08
+// Extended IDs carry an 'x' suffix. Only "base hex" logs are supported.
+static bool parseAscLine(const char* line, LogRecord& record)
+{
+    double seconds;
+    int channel;
+    char id[16], direction[8], type;
+    unsigned dlc;
+    int offset = 0;
+    if (sscanf(line, " %lf %d %15s %7s %c %u%n", &seconds, &channel, id, direction, &type, &dlc, &offset) != 6 || type != 'd' || dlc > 8)
+        return false;
+
+    size_t idLength = strlen(id);
+    bool extended = idLength > 0 && (id[idLength - 1] == 'x' || id[idLength - 1] == 'X');
+    uint32_t canId = static_cast<uint32_t>(strtoul(id, nullptr, 16));
+    record.canId = extended ? (canId & CAN_EFF_MASK) | CAN_EFF_FLAG : canId;
+    record.timestampNs = static_cast<uint64_t>(seconds * 1e9);
+    record.dlc = static_cast<uint8_t>(dlc);
+
+    const char* rest = line + offset;
+    for (unsigned i = 0; i < dlc; i++)
+    {
+        unsigned byte;
+        if (sscanf(rest, " %2x%n", &byte, &offset) != 1)
+            return false;
+        record.data[i] = static_cast<uint8_t>(byte);
+        rest += offset;
+    }
+    return true;
+}
+
+bool ReplaySource::openText(const char* path)
+{
+    FILE* f = fopen(path, "r");
+    if (!f)
+    {
+        perror("Replay log open");
+        return false;
+    }
+
+    char line[512];
+    size_t skipped = 0;
+    while (fgets(line, sizeof(line), f))
+    {
+        if (strstr(line, "base dec"))
+            fprintf(stderr, "%s: decimal ASC logs are not supported, IDs will be wrong\n", path);
+
+        LogRecord record;
+        memset(&record, 0, sizeof(record));
+        if (parseCandumpLine(line, record) || parseAscLine(line, record))
+            textRecords.push_back(record);
+        else
+            skipped++;
+    }
+    fclose(f);
+
+    if (textRecords.empty())
+    {
+        fprintf(stderr, "%s: no CAN frames found\n", path);
+        return false;
+    }
+
+    printf("Replay: %zu frames from %s (%zu other lines skipped)\n", textRecords.size(), path, skipped);
+    return true;
+}
+
+bool ReplaySource::open(const char* path)
+{
+    // Our own logs start with the file magic, anything else is treated as text
+    char magic[sizeof(LOG_FILE_MAGIC)] = {};
+    FILE* f = fopen(path, "rb");
+    if (!f)
+    {
+        perror("Replay log open");
+        return false;
+    }
+    size_t magicLength = fread(magic, 1, sizeof(magic), f);
+    fclose(f);
+
+    binary = magicLength == sizeof(magic) && memcmp(magic, LOG_FILE_MAGIC, sizeof(magic)) == 0;
+    if (!binary)
+        return openText(path);
+
+    if (!binaryLog.open(path))
+        return false;
+    binaryCursor = binaryLog.begin();
+    printf("Replay: %zu blocks from %s (recorded as %s)\n", binaryLog.blocks(), path, binaryLog.header().profile);
+    return true;
+}
+
+const char* ReplaySource::recordedProfile() const
+{
+    return binary ? binaryLog.header().profile : "";
+}
+
+void ReplaySource::setSpeed(double newSpeed)
+{
+    speed.store(newSpeed, std::memory_order_relaxed);
+}
+
+void ReplaySource::setStepping(bool enabled)
+{
+    stepping.store(enabled, std::memory_order_relaxed);
+    stepSignal.notify_one();
+}
+
+void ReplaySource::step()
+{
+    {
+        std::lock_guard<std::mutex> lock(stepMutex);
+        stepsRequested++;
+    }
+    stepSignal.notify_one();
+}
+
+void ReplaySource::interrupt()
+{
+    {
+        std::lock_guard<std::mutex> lock(stepMutex);
+        wakeRequested = true;
+    }
+    stepSignal.notify_one();
+}
+
+bool ReplaySource::nextRecord(LogRecord& record)
+{
+    if (binary)
+    {
+        const LogRecord* next = binaryCursor.next();
+        if (!next)
+            return false;
+        record = *next;
+        return true;
+    }
+
+    if (textIndex >= textRecords.size())
+        return false;
+    record = textRecords[textIndex++];
+    return true;
+}
+
+// Prints the replay rate; at speed 0 this is the decode path's throughput
+void ReplaySource::finish()
+{
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startedAt).count();
+    printf("Replay finished: %llu frames in %.3f s (%.0f frames/s)\n",
+        (unsigned long long)framesReplayed, seconds, seconds > 0.0 ? framesReplayed / seconds : 0.0);
+    fflush(stdout);
+}
+
+int ReplaySource::receive(FrameBatch& batch)
+{
+    if (!started)
+    {
+        startedAt = std::chrono::steady_clock::now();
+        started = true;
+    }
+
+    if (!hasPending)
+    {
+        if (!nextRecord(pending))
+        {
+            finish();
+            return -1;
+        }
+        hasPending = true;
+    }
+
+    int count = 0;
+    auto emit = [&]() {
+        struct can_frame& frame = batch.frames[count];
+        memset(&frame, 0, sizeof(frame));
+        frame.can_id = pending.canId;
+        frame.can_dlc = pending.dlc;
+        memcpy(frame.data, pending.data, sizeof(frame.data));
+        batch.timestamps[count] = realtimeNs();
+        count++;
+        framesReplayed++;
+        hasPending = nextRecord(pending);
+    };
+
+    if (stepping.load(std::memory_order_relaxed))
+    {
+        std::unique_lock<std::mutex> lock(stepMutex);
+        if (!stepSignal.wait_for(lock, REPLAY_MAX_WAIT, [this] { return stepsRequested > 0 || wakeRequested || !stepping.load(std::memory_order_relaxed); }))
+            return 0;
+        if (wakeRequested)
+        {
+            wakeRequested = false;
+            return 0;
+        }
+        if (stepsRequested == 0)
+            return 0; // Stepping was switched off, pick up the normal pacing next call
+        stepsRequested--;
+        lock.unlock();
+
+        emit();
+        anchorSpeed = -1.0; // Re-anchor paced playback from here if stepping ends
+        return count;
+    }
+
+    double currentSpeed = speed.load(std::memory_order_relaxed);
+    if (currentSpeed <= 0.0)
+    {
+        while (hasPending && count < CAN_BATCH_SIZE)
+            emit();
+        return count;
+    }
+
+    // Paced: map log time onto wall time from the anchor
+    auto now = std::chrono::steady_clock::now();
+    if (currentSpeed != anchorSpeed)
+    {
+        anchorWall = now;
+        anchorLogNs = pending.timestampNs;
+        anchorSpeed = currentSpeed;
+    }
+
+    auto dueAt = [&](uint64_t logNs) {
+        double offsetNs = logNs > anchorLogNs ? (logNs - anchorLogNs) / currentSpeed : 0.0;
+        return anchorWall + std::chrono::nanoseconds(static_cast<int64_t>(offsetNs));
+    };
+
+    auto due = dueAt(pending.timestampNs);
+    if (due > now)
+    {
+        // Sleep on the step condition so interrupt() can end the wait early
+        std::unique_lock<std::mutex> lock(stepMutex);
+        if (stepSignal.wait_until(lock, due < now + REPLAY_MAX_WAIT ? due : now + REPLAY_MAX_WAIT, [this] { return wakeRequested; }))
+        {
+            wakeRequested = false;
+            return 0;
+        }
+        lock.unlock();
+        now = std::chrono::steady_clock::now();
+        if (due > now)
+            return 0;
+    }
+
+    while (hasPending && count < CAN_BATCH_SIZE && dueAt(pending.timestampNs) <= now)
+        emit();
+    return count;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include "frame_source.h"
+#include "session_log.h"
+#include "session_log_reader.h"
+
+// Plays a recorded session back into the decoder as if it were arriving off the bus.
+// Reads candump text logs (candump -l "(time) can0 123#DEADBEEF", or -ta with "[dlc]"),
+// Vector ASC logs, and the dash's own binary session logs.
+//
+// speed 1 keeps the original gaps between frames, 2 or 10 plays that much faster, and
+// 0 plays as fast as the decoder will take it (which makes it a decode benchmark).
+// In stepping mode one frame is released per step() call.
+// Frames are restamped with their replay time so data-age measurements stay meaningful.
+class ReplaySource : public FrameSource
+{
+public:
+    bool open(const char* path);
+
+    int receive(FrameBatch& batch) override;
+
+    const char* name() const override
+    {
+        return "replay";
+    }
+
+    // Safe to call from the render thread while replaying
+    void setSpeed(double newSpeed);
+    void setStepping(bool enabled);
+    void step();
+
+    // Cuts short a stepping or pacing wait in receive()
+    void interrupt() override;
+
+    bool isStepping() const
+    {
+        return stepping.load(std::memory_order_relaxed);
+    }
+
+    // Profile name stored in a binary log, empty for text logs
+    const char* recordedProfile() const;
+
+private:
+    bool openText(const char* path);
+    bool nextRecord(LogRecord& record);
+    void finish();
+
+    bool binary = false;
+    std::vector<LogRecord> textRecords; // Whole text log parsed up front
+    size_t textIndex = 0;
+    SessionLogReader binaryLog;
+    SessionLogReader::Cursor binaryCursor;
+
+    LogRecord pending;       // Next frame to hand out
+    bool hasPending = false;
+
+    // Wall clock <-> log clock anchor for paced playback, reset when the speed changes
+    std::chrono::steady_clock::time_point anchorWall;
+    uint64_t anchorLogNs = 0;
+    double anchorSpeed = -1.0;
+
+    std::atomic<double> speed{1.0};
+    std::atomic<bool> stepping{false};
+    std::mutex stepMutex;
+    std::condition_variable stepSignal;
+    int stepsRequested = 0;
+    bool wakeRequested = false; // Set by interrupt(), cleared by the wait it cut short
+
+    uint64_t framesReplayed = 0;
+    std::chrono::steady_clock::time_point startedAt;
+    bool started = false;
+};
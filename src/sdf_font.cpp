@@ -0,0 +1,413 @@
+#include "sdf_font.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <algorithm>
+
+#include "font_cache.h"
+
+#define GL_GLEXT_PROTOTYPES // Shader entry points are exported by libGL on Linux
+#include <GL/gl.h>
+#include <GL/glext.h>
+
+// Our own private copy of stb_truetype, imgui_draw.cpp keeps its one static too
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#endif
+#define STBTT_STATIC
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "imstb_truetype.h"
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+#define SDF_CACHE_MAGIC "WRDSDF1"
+#define SDF_ATLAS_WIDTH 256
+#define SDF_ON_EDGE 128 // Distance field value on the outline, the shader's 0.5
+
+static const char* sdfVertexShader =
+    "#version 110\n"
+    "void main()\n"
+    "{\n"
+    "    gl_Position = ftransform();\n"
+    "    gl_TexCoord[0] = gl_MultiTexCoord0;\n"
+    "    gl_FrontColor = gl_Color;\n"
+    "}\n";
+
+// fwidth() keeps the soft edge about a screen pixel wide whatever size the text is drawn at
+static const char* sdfFragmentShader =
+    "#version 110\n"
+    "uniform sampler2D distanceField;\n"
+    "void main()\n"
+    "{\n"
+    "    float distance = texture2D(distanceField, gl_TexCoord[0].st).a;\n"
+    "    float smoothing = 0.7 * fwidth(distance);\n"
+    "    float coverage = smoothstep(0.5 - smoothing, 0.5 + smoothing, distance);\n"
+    "    gl_FragColor = vec4(gl_Color.rgb, gl_Color.a * coverage);\n"
+    "}\n";
+
+struct SdfCacheHeader
+{
+    char magic[8];
+    uint64_t key;
+    int32_t padding;
+    int32_t width;
+    int32_t height;
+    int32_t glyphCount;
+};
+
+bool SdfFont::bake(const char* path, const ImWchar* ranges)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f)
+    {
+        perror("SDF font open");
+        return false;
+    }
+    std::vector<unsigned char> ttf;
+    unsigned char buffer[65536];
+    size_t length;
+    while ((length = fread(buffer, 1, sizeof(buffer), f)) > 0)
+        ttf.insert(ttf.end(), buffer, buffer + length);
+    fclose(f);
+
+    stbtt_fontinfo info;
+    if (ttf.empty() || !stbtt_InitFont(&info, ttf.data(), stbtt_GetFontOffsetForIndex(ttf.data(), 0)))
+    {
+        fprintf(stderr, "%s: not a TrueType font\n", path);
+        return false;
+    }
+
+    // Same scale and ascent rounding as ImGui so readouts sit where the bitmap font put them
+    float scale = stbtt_ScaleForPixelHeight(&info, SDF_BAKE_SIZE);
+    int ascent, descent, lineGap;
+    stbtt_GetFontVMetrics(&info, &ascent, &descent, &lineGap);
+    float ascentPixels = floorf(ascent * scale + 1.0f);
+
+    struct Bitmap
+    {
+        unsigned char* data;
+        int width, height, x, y;
+    };
+    std::vector<Bitmap> bitmaps;
+    codepoints.clear();
+    glyphs.clear();
+
+    // Shelf pack as we go, the atlas is only a couple of rows of digits
+    int penX = 0, penY = 0, shelfHeight = 0;
+    for (const ImWchar* range = ranges; range[0] && range[1]; range += 2)
+    {
+        for (unsigned int codepoint = range[0]; codepoint <= range[1]; codepoint++)
+        {
+            if (stbtt_FindGlyphIndex(&info, codepoint) == 0)
+                continue;
+
+            int advance, leftBearing;
+            stbtt_GetCodepointHMetrics(&info, codepoint, &advance, &leftBearing);
+
+            Bitmap bitmap = {};
+            int xOffset = 0, yOffset = 0;
+            bitmap.data = stbtt_GetCodepointSDF(&info, scale, codepoint, SDF_PADDING, SDF_ON_EDGE, (float)SDF_ON_EDGE / SDF_PADDING,
+                &bitmap.width, &bitmap.height, &xOffset, &yOffset);
+
+            Glyph glyph = {};
+            glyph.advance = advance * scale;
+            if (bitmap.data)
+            {
+                if (penX + bitmap.width > SDF_ATLAS_WIDTH)
+                {
+                    penX = 0;
+                    penY += shelfHeight + 1;
+                    shelfHeight = 0;
+                }
+                bitmap.x = penX;
+                bitmap.y = penY;
+                penX += bitmap.width + 1;
+                shelfHeight = std::max(shelfHeight, bitmap.height);
+
+                glyph.x0 = (float)xOffset;
+                glyph.y0 = ascentPixels + yOffset;
+                glyph.x1 = glyph.x0 + bitmap.width;
+                glyph.y1 = glyph.y0 + bitmap.height;
+                bitmaps.push_back(bitmap);
+            }
+            codepoints.push_back(codepoint);
+            glyphs.push_back(glyph);
+        }
+    }
+
+    width = SDF_ATLAS_WIDTH;
+    height = penY + shelfHeight;
+    pixels.assign((size_t)width * height, 0);
+
+    // UVs once the final height is known, glyphs with a bitmap are in the same order as bitmaps
+    size_t next = 0;
+    for (Glyph& glyph : glyphs)
+    {
+        if (glyph.x1 == glyph.x0)
+            continue;
+        const Bitmap& bitmap = bitmaps[next++];
+        for (int row = 0; row < bitmap.height; row++)
+            memcpy(&pixels[(size_t)(bitmap.y + row) * width + bitmap.x], bitmap.data + row * bitmap.width, bitmap.width);
+        stbtt_FreeSDF(bitmap.data, nullptr);
+
+        glyph.u0 = (float)bitmap.x / width;
+        glyph.v0 = (float)bitmap.y / height;
+        glyph.u1 = (float)(bitmap.x + bitmap.width) / width;
+        glyph.v1 = (float)(bitmap.y + bitmap.height) / height;
+    }
+
+    fallback = findGlyph('?');
+    if (glyphs.empty())
+    {
+        fprintf(stderr, "%s: none of the requested glyphs are in the font\n", path);
+        return false;
+    }
+    return true;
+}
+
+bool SdfFont::readCache(const char* path, uint64_t key)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f)
+        return false;
+
+    SdfCacheHeader header;
+    bool ok = fread(&header, sizeof(header), 1, f) == 1
+        && memcmp(header.magic, SDF_CACHE_MAGIC, sizeof(header.magic)) == 0
+        && header.key == key && header.padding == SDF_PADDING
+        && header.width > 0 && header.height > 0 && header.glyphCount > 0;
+    if (ok)
+    {
+        width = header.width;
+        height = header.height;
+        codepoints.resize(header.glyphCount);
+        glyphs.resize(header.glyphCount);
+        pixels.resize((size_t)width * height);
+        ok = fread(codepoints.data(), sizeof(unsigned int), codepoints.size(), f) == codepoints.size()
+            && fread(glyphs.data(), sizeof(Glyph), glyphs.size(), f) == glyphs.size()
+            && fread(pixels.data(), 1, pixels.size(), f) == pixels.size();
+    }
+    fclose(f);
+
+    if (!ok)
+    {
+        codepoints.clear();
+        glyphs.clear();
+        pixels.clear();
+        return false;
+    }
+    fallback = findGlyph('?');
+    return true;
+}
+
+void SdfFont::writeCache(const char* path, uint64_t key) const
+{
+    // Same write-then-rename as the bitmap atlas cache
+    char tempPath[512];
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+    FILE* f = fopen(tempPath, "wb");
+    if (!f)
+    {
+        perror("SDF font cache");
+        return;
+    }
+
+    SdfCacheHeader header = {};
+    memcpy(header.magic, SDF_CACHE_MAGIC, sizeof(header.magic));
+    header.key = key;
+    header.padding = SDF_PADDING;
+    header.width = width;
+    header.height = height;
+    header.glyphCount = (int32_t)glyphs.size();
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1
+        && fwrite(codepoints.data(), sizeof(unsigned int), codepoints.size(), f) == codepoints.size()
+        && fwrite(glyphs.data(), sizeof(Glyph), glyphs.size(), f) == glyphs.size()
+        && fwrite(pixels.data(), 1, pixels.size(), f) == pixels.size();
+    ok = fclose(f) == 0 && ok;
+
+    if (!ok || rename(tempPath, path) != 0)
+    {
+        perror("SDF font cache");
+        remove(tempPath);
+    }
+}
+
+bool SdfFont::load(const char* path, const ImWchar* ranges, const char* cacheDirectory, bool& fromCache)
+{
+    fromCache = false;
+
+    // Keyed like the bitmap atlas, on the font file, bake size and glyph ranges
+    const FontSpec spec = { path, SDF_BAKE_SIZE, ranges };
+    uint64_t key;
+    if (!fontCacheKey(&spec, 1, key))
+    {
+        fprintf(stderr, "Can't read font %s\n", path);
+        return false;
+    }
+
+    char cachePath[512];
+    snprintf(cachePath, sizeof(cachePath), "%s/sdf-%016llx.atlas", cacheDirectory, (unsigned long long)key);
+    if (readCache(cachePath, key))
+    {
+        fromCache = true;
+        return true;
+    }
+
+    if (!bake(path, ranges))
+        return false;
+    mkdir(cacheDirectory, 0755);
+    writeCache(cachePath, key);
+    return true;
+}
+
+static GLuint compileShader(GLenum type, const char* source)
+{
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+
+    GLint compiled = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+    if (!compiled)
+    {
+        char log[1024];
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        fprintf(stderr, "SDF %s shader: %s\n", type == GL_VERTEX_SHADER ? "vertex" : "fragment", log);
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+bool SdfFont::createProgram()
+{
+    GLuint vertex = compileShader(GL_VERTEX_SHADER, sdfVertexShader);
+    GLuint fragment = compileShader(GL_FRAGMENT_SHADER, sdfFragmentShader);
+    if (vertex && fragment)
+    {
+        program = glCreateProgram();
+        glAttachShader(program, vertex);
+        glAttachShader(program, fragment);
+        glLinkProgram(program);
+
+        GLint linked = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (!linked)
+        {
+            char log[1024];
+            glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+            fprintf(stderr, "SDF shader link: %s\n", log);
+            glDeleteProgram(program);
+            program = 0;
+        }
+    }
+    if (vertex)
+        glDeleteShader(vertex);
+    if (fragment)
+        glDeleteShader(fragment);
+    if (!program)
+        return false;
+
+    GLint lastProgram;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &lastProgram);
+    glUseProgram(program);
+    glUniform1i(glGetUniformLocation(program, "distanceField"), 0);
+    glUseProgram(lastProgram);
+    return true;
+}
+
+void SdfFont::createTexture()
+{
+    // Linear filtering is what turns the distance field back into a smooth edge
+    GLint lastTexture, lastUnpackAlignment;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &lastTexture);
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &lastUnpackAlignment);
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, width, height, 0, GL_ALPHA, GL_UNSIGNED_BYTE, pixels.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, lastUnpackAlignment);
+    glBindTexture(GL_TEXTURE_2D, lastTexture);
+}
+
+bool SdfFont::createDeviceObjects(bool withShader)
+{
+    if (withShader && !createProgram())
+        return false;
+    createTexture();
+    return true;
+}
+
+void SdfFont::destroyDeviceObjects()
+{
+    if (texture)
+        glDeleteTextures(1, &texture);
+    if (program)
+        glDeleteProgram(program);
+    texture = 0;
+    program = 0;
+}
+
+const SdfFont::Glyph* SdfFont::findGlyph(unsigned int codepoint) const
+{
+    auto it = std::lower_bound(codepoints.begin(), codepoints.end(), codepoint);
+    if (it == codepoints.end() || *it != codepoint)
+        return fallback;
+    return &glyphs[it - codepoints.begin()];
+}
+
+float SdfFont::textWidth(const char* text, float size) const
+{
+    float advance = 0.0f;
+    for (const unsigned char* c = (const unsigned char*)text; *c; c++)
+    {
+        const Glyph* glyph = findGlyph(*c);
+        if (glyph)
+            advance += glyph->advance;
+    }
+    return advance * size / SDF_BAKE_SIZE;
+}
+
+void SdfFont::beginDraw(const ImDrawList*, const ImDrawCmd* cmd)
+{
+    glUseProgram(static_cast<const SdfFont*>(cmd->UserCallbackData)->program);
+}
+
+void SdfFont::endDraw(const ImDrawList*, const ImDrawCmd*)
+{
+    glUseProgram(0);
+}
+
+void SdfFont::addText(ImDrawList* drawList, ImVec2 pos, float size, ImU32 color, const char* text) const
+{
+    float scale = size / SDF_BAKE_SIZE;
+    if (program)
+        drawList->AddCallback(beginDraw, const_cast<SdfFont*>(this));
+    drawList->PushTextureID((ImTextureID)(intptr_t)texture);
+    float penX = pos.x;
+    for (const unsigned char* c = (const unsigned char*)text; *c; c++)
+    {
+        const Glyph* glyph = findGlyph(*c);
+        if (!glyph)
+            continue;
+        if (glyph->x1 > glyph->x0)
+        {
+            drawList->PrimReserve(6, 4);
+            drawList->PrimRectUV(ImVec2(penX + glyph->x0 * scale, pos.y + glyph->y0 * scale),
+                ImVec2(penX + glyph->x1 * scale, pos.y + glyph->y1 * scale),
+                ImVec2(glyph->u0, glyph->v0), ImVec2(glyph->u1, glyph->v1), color);
+        }
+        penX += glyph->advance * scale;
+    }
+    drawList->PopTextureID();
+    if (program)
+        drawList->AddCallback(endDraw, nullptr);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#include "imgui.h"
+
+// Signed distance field glyphs for the big readouts. One small atlas baked at
+// SDF_BAKE_SIZE draws crisply at any size, where the bitmap font needs a full atlas
+// entry per pixel size and goes soft when scaled. Glyphs are queued into an ImGui draw
+// list like normal text. Under imgui_impl_opengl2 draw callbacks either side switch to
+// our own distance field shader and back; imgui_impl_gles2 has the shader built in and
+// only needs to be told the texture.
+#define SDF_BAKE_SIZE 48.0f
+#define SDF_PADDING 6 // Pixels of distance kept around each glyph, the widest edge the shader can soften
+
+class SdfFont
+{
+public:
+    // Distance field atlas for ranges' glyphs, CPU side only. Baking takes tens of ms even
+    // on a desktop CPU, so the result is kept in cacheDirectory next to the bitmap atlas;
+    // fromCache says whether it came from there.
+    bool load(const char* path, const ImWchar* ranges, const char* cacheDirectory, bool& fromCache);
+
+    // Texture, plus the fixed function compatible shader if withShader. Needs the GL
+    // context. False if the shader doesn't build, in which case the caller should stick
+    // to the bitmap font.
+    bool createDeviceObjects(bool withShader);
+    void destroyDeviceObjects();
+
+    ImTextureID textureId() const
+    {
+        return (ImTextureID)(intptr_t)texture;
+    }
+
+    float textWidth(const char* text, float size) const;
+
+    // Queues text with its top left at pos, line height size like ImFont
+    void addText(ImDrawList* drawList, ImVec2 pos, float size, ImU32 color, const char* text) const;
+
+    int atlasWidth() const
+    {
+        return width;
+    }
+
+    int atlasHeight() const
+    {
+        return height;
+    }
+
+private:
+    struct Glyph
+    {
+        float advance;
+        float x0, y0, x1, y1; // Quad relative to the pen at the top of the line, in bake pixels
+        float u0, v0, u1, v1;
+    };
+
+    bool bake(const char* path, const ImWchar* ranges);
+    bool readCache(const char* path, uint64_t key);
+    bool createProgram();
+    void createTexture();
+    void writeCache(const char* path, uint64_t key) const;
+    const Glyph* findGlyph(unsigned int codepoint) const;
+
+    static void beginDraw(const ImDrawList* drawList, const ImDrawCmd* cmd);
+    static void endDraw(const ImDrawList* drawList, const ImDrawCmd* cmd);
+
+    std::vector<unsigned int> codepoints; // Sorted, parallel to glyphs
+    std::vector<Glyph> glyphs;
+    const Glyph* fallback = nullptr;
+    std::vector<uint8_t> pixels; // Alpha8, 128 on the glyph edge
+    int width = 0;
+    int height = 0;
+
+    unsigned int texture = 0;
+    unsigned int program = 0; // Only when drawing through imgui_impl_opengl2
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// On-disk layout of a dash session log (*.wrdlog).
+//
+// The file is a sequence of fixed-size blocks. Block 0 holds LogFileHeader, every
+// following block is a LogBlockHeader plus up to LOG_RECORDS_PER_BLOCK LogRecords,
+// zero padded to LOG_BLOCK_SIZE. The last block is written in place as it fills and may
+// be short if the dash stopped without closing the log. Blocks are written in time order and each header
+// carries its first/last timestamp, so the block headers double as a sparse time
+// index: a reader can binary search them by block number without scanning records.
+// All fields are little-endian (the dash only runs on little-endian targets).
+
+#define LOG_BLOCK_SIZE 65536
+#define LOG_FILE_MAGIC "WRDLOG1"
+#define LOG_BLOCK_MAGIC 0x4B4C4257u // "WBLK"
+#define LOG_VERSION 1
+
+struct LogFileHeader
+{
+    char magic[8];            // LOG_FILE_MAGIC
+    uint32_t version;         // LOG_VERSION
+    uint32_t blockSize;       // LOG_BLOCK_SIZE
+    uint64_t startTimeNs;     // Wall clock when logging started
+    uint32_t flushIntervalMs; // Longest a record waited before being written and synced
+    char profile[16];         // Vehicle profile the session was recorded with
+};
+
+struct LogBlockHeader
+{
+    uint32_t magic;            // LOG_BLOCK_MAGIC
+    uint32_t recordCount;
+    uint64_t sequence;         // Block number, starting at 1 for the first data block
+    uint64_t firstTimestampNs;
+    uint64_t lastTimestampNs;
+};
+
+// One received CAN frame
+struct LogRecord
+{
+    uint64_t timestampNs;
+    uint32_t canId;       // Including the EFF/RTR/ERR flag bits
+    uint8_t dlc;
+    uint8_t reserved[3];
+    uint8_t data[8];
+};
+
+static_assert(sizeof(LogFileHeader) <= LOG_BLOCK_SIZE, "File header must fit in block 0");
+static_assert(sizeof(LogBlockHeader) == 32, "Log block header layout changed");
+static_assert(sizeof(LogRecord) == 24, "Log record layout changed");
+
+#define LOG_RECORDS_PER_BLOCK ((LOG_BLOCK_SIZE - sizeof(LogBlockHeader)) / sizeof(LogRecord))
@@ -0,0 +1,134 @@
+#include "session_log_reader.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+
+SessionLogReader::~SessionLogReader()
+{
+    close();
+}
+
+bool SessionLogReader::open(const char* path)
+{
+    close();
+
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        perror("Session log open");
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size < LOG_BLOCK_SIZE)
+    {
+        fprintf(stderr, "%s: not a session log (too short)\n", path);
+        ::close(fd);
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        perror("Session log mmap");
+        return false;
+    }
+
+    mapping = static_cast<const uint8_t*>(mapped);
+    mappingSize = st.st_size;
+
+    const LogFileHeader& fileHeader = header();
+    if (memcmp(fileHeader.magic, LOG_FILE_MAGIC, sizeof(fileHeader.magic)) != 0 || fileHeader.version != LOG_VERSION || fileHeader.blockSize != LOG_BLOCK_SIZE)
+    {
+        fprintf(stderr, "%s: not a version %d session log\n", path, LOG_VERSION);
+        close();
+        return false;
+    }
+
+    // Only blocks with a valid header count. The last one may be short if the dash
+    // stopped mid-block; it holds as many records as made it to disk.
+    blockCount = 0;
+    for (;;)
+    {
+        size_t offset = (blockCount + 1) * LOG_BLOCK_SIZE;
+        if (offset + sizeof(LogBlockHeader) > mappingSize || block(blockCount).magic != LOG_BLOCK_MAGIC || block(blockCount).recordCount > LOG_RECORDS_PER_BLOCK)
+            break;
+
+        size_t present = (std::min<size_t>(mappingSize - offset, LOG_BLOCK_SIZE) - sizeof(LogBlockHeader)) / sizeof(LogRecord);
+        blockCount++;
+        if (present < block(blockCount - 1).recordCount)
+        {
+            if (present == 0)
+                blockCount--;
+            lastBlockRecords = present;
+            break;
+        }
+    }
+
+    madvise(mapped, mappingSize, MADV_SEQUENTIAL);
+    return true;
+}
+
+void SessionLogReader::close()
+{
+    if (mapping)
+        munmap(const_cast<uint8_t*>(mapping), mappingSize);
+    mapping = nullptr;
+    mappingSize = 0;
+    blockCount = 0;
+    lastBlockRecords = 0;
+}
+
+uint64_t SessionLogReader::firstTimestampNs() const
+{
+    return blockCount ? block(0).firstTimestampNs : 0;
+}
+
+uint64_t SessionLogReader::lastTimestampNs() const
+{
+    if (!blockCount)
+        return 0;
+    return lastBlockRecords ? records(blockCount - 1)[lastBlockRecords - 1].timestampNs : block(blockCount - 1).lastTimestampNs;
+}
+
+SessionLogReader::Cursor SessionLogReader::seek(uint64_t timestampNs) const
+{
+    // Last block starting at or before timestampNs; the record we want is in it or is
+    // the first record of the next block
+    size_t low = 0, high = blockCount;
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+        if (block(mid).firstTimestampNs <= timestampNs)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    Cursor cursor;
+    cursor.reader = this;
+    cursor.blockIndex = low > 0 ? low - 1 : 0;
+
+    // Then binary search the records inside that block
+    if (cursor.blockIndex < blockCount)
+    {
+        const LogRecord* blockRecords = records(cursor.blockIndex);
+        uint32_t first = 0, last = recordCount(cursor.blockIndex);
+        while (first < last)
+        {
+            uint32_t mid = first + (last - first) / 2;
+            if (blockRecords[mid].timestampNs < timestampNs)
+                first = mid + 1;
+            else
+                last = mid;
+        }
+        cursor.recordIndex = first;
+    }
+    return cursor;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "can_decoder.h"
+#include "session_log.h"
+
+// Read-only view of a session log written by SessionLogger. The file is mmap()ed and
+// records are handed out as pointers into the mapping, so iterating copies nothing.
+// Seeking binary searches the per-block timestamps (see session_log.h), which makes
+// jumping anywhere in a multi-gigabyte log O(log blocks).
+class SessionLogReader
+{
+public:
+    // Walks records in file order from wherever seek() put it
+    class Cursor
+    {
+    public:
+        // Next record, or nullptr at the end of the log
+        const LogRecord* next()
+        {
+            while (reader && blockIndex < reader->blockCount)
+            {
+                if (recordIndex < reader->recordCount(blockIndex))
+                    return reader->records(blockIndex) + recordIndex++;
+                blockIndex++;
+                recordIndex = 0;
+            }
+            return nullptr;
+        }
+
+    private:
+        friend class SessionLogReader;
+        const SessionLogReader* reader = nullptr;
+        size_t blockIndex = 0;
+        uint32_t recordIndex = 0;
+    };
+
+    SessionLogReader() = default;
+    SessionLogReader(const SessionLogReader&) = delete;
+    SessionLogReader& operator=(const SessionLogReader&) = delete;
+    ~SessionLogReader();
+
+    // Maps path and validates its header. Trailing blocks without a valid header (e.g.
+    // power was cut) are ignored, and a short last block is read up to where it ends.
+    bool open(const char* path);
+    void close();
+
+    const LogFileHeader& header() const
+    {
+        return *reinterpret_cast<const LogFileHeader*>(mapping);
+    }
+
+    size_t blocks() const
+    {
+        return blockCount;
+    }
+
+    uint64_t firstTimestampNs() const;
+    uint64_t lastTimestampNs() const;
+
+    // Cursor at the first record with a timestamp at or after timestampNs
+    Cursor seek(uint64_t timestampNs) const;
+
+    // Cursor at the first record of the log
+    Cursor begin() const
+    {
+        Cursor cursor;
+        cursor.reader = this;
+        return cursor;
+    }
+
+private:
+    // Data block i (0-based, i.e. file block i + 1)
+    const LogBlockHeader& block(size_t i) const
+    {
+        return *reinterpret_cast<const LogBlockHeader*>(mapping + (i + 1) * LOG_BLOCK_SIZE);
+    }
+
+    uint32_t recordCount(size_t i) const
+    {
+        return lastBlockRecords && i == blockCount - 1 ? lastBlockRecords : block(i).recordCount;
+    }
+
+    const LogRecord* records(size_t i) const
+    {
+        return reinterpret_cast<const LogRecord*>(mapping + (i + 1) * LOG_BLOCK_SIZE + sizeof(LogBlockHeader));
+    }
+
+    const uint8_t* mapping = nullptr;
+    size_t mappingSize = 0;
+    size_t blockCount = 0;
+    uint32_t lastBlockRecords = 0; // Records actually present in a short last block, 0 if it is whole
+};
+
+// Decodes records from cursor until one at or after endNs (not consumed) or the end of
+// the log, through the same decoder tables the live CAN thread uses. Returns false once
+// the log is exhausted. decoder is a ProfileDecoder or a DbcDecoder.
+template <typename Decoder>
+bool decodeLogUntil(const Decoder& decoder, SessionLogReader::Cursor& cursor, uint64_t endNs, CANBusData& canData, HistoryStore* history = nullptr)
+{
+    for (;;)
+    {
+        SessionLogReader::Cursor peek = cursor;
+        const LogRecord* record = peek.next();
+        if (!record)
+            return false;
+        if (record->timestampNs >= endNs)
+            return true;
+
+        decoder.decode(record->canId, record->data, record->timestampNs, canData, history);
+        cursor = peek;
+    }
+}
@@ -0,0 +1,193 @@
+#include "session_logger.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <chrono>
+
+#include "timestamp.h"
+
+#define LOG_DRAIN_BATCH 1024 // Records popped per queue read
+#define LOG_IDLE_SLEEP_MS 2  // Writer nap when the queue is empty, well inside LOG_QUEUE_SIZE of headroom
+
+SessionLogger::~SessionLogger()
+{
+    stop();
+}
+
+bool SessionLogger::start(const char* path, const char* profile, uint32_t flushInterval)
+{
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        perror("Session log open");
+        return false;
+    }
+
+    if (posix_memalign(reinterpret_cast<void**>(&block), LOG_BLOCK_SIZE, LOG_BLOCK_SIZE) != 0)
+    {
+        fprintf(stderr, "Session log buffer allocation failed\n");
+        close(fd);
+        fd = -1;
+        return false;
+    }
+
+    // Block 0 is the file header
+    memset(block, 0, LOG_BLOCK_SIZE);
+    LogFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LOG_FILE_MAGIC, sizeof(header.magic));
+    header.version = LOG_VERSION;
+    header.blockSize = LOG_BLOCK_SIZE;
+    header.startTimeNs = realtimeNs();
+    header.flushIntervalMs = flushInterval;
+    strncpy(header.profile, profile, sizeof(header.profile) - 1);
+    memcpy(block, &header, sizeof(header));
+
+    if (write(fd, block, LOG_BLOCK_SIZE) != LOG_BLOCK_SIZE)
+    {
+        perror("Session log header write");
+        close(fd);
+        fd = -1;
+        return false;
+    }
+    writtenBytes = LOG_BLOCK_SIZE;
+
+    flushIntervalMs = flushInterval;
+    blockOffset = LOG_BLOCK_SIZE;
+    blockRecords = 0;
+    blockFlushedRecords = 0;
+    blockSequence = 0;
+    stopping = false;
+    writerThread = std::thread(&SessionLogger::writerLoop, this);
+    return true;
+}
+
+void SessionLogger::stop()
+{
+    if (!writerThread.joinable())
+        return;
+
+    stopping = true;
+    writerThread.join();
+
+    // Pad a partly written last block out to LOG_BLOCK_SIZE so the file is whole blocks
+    if (blockFlushedRecords > 0 && ftruncate(fd, blockOffset + LOG_BLOCK_SIZE) < 0)
+        perror("Session log truncate");
+
+    close(fd);
+    fd = -1;
+    free(block);
+    block = nullptr;
+}
+
+// Fills the current block from the queue and writes it out when it is full, or when
+// records have waited flushIntervalMs. Every write is fdatasync()ed, so a power cut
+// loses at most flushIntervalMs of frames.
+void SessionLogger::writerLoop()
+{
+    LogRecord records[LOG_DRAIN_BATCH];
+    auto blockOpened = std::chrono::steady_clock::now();
+
+    for (;;)
+    {
+        bool finalPass = stopping.load(std::memory_order_acquire);
+        size_t count = queue.pop(records, LOG_DRAIN_BATCH);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            if (blockRecords == blockFlushedRecords)
+                blockOpened = std::chrono::steady_clock::now();
+
+            LogRecord* slot = reinterpret_cast<LogRecord*>(block + sizeof(LogBlockHeader)) + blockRecords;
+            *slot = records[i];
+            blockRecords++;
+
+            if (blockRecords == LOG_RECORDS_PER_BLOCK && !writeBlock())
+                return;
+        }
+
+        if (count > 0)
+            continue;
+
+        // Queue is empty: flush records that have waited too long, finish up, or nap
+        bool pending = blockRecords > blockFlushedRecords;
+        bool stale = pending && std::chrono::steady_clock::now() - blockOpened >= std::chrono::milliseconds(flushIntervalMs);
+        if ((stale || finalPass) && pending && !writeBlock())
+            return;
+        if (finalPass)
+            return;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(LOG_IDLE_SLEEP_MS));
+    }
+}
+
+static bool writeAt(int fd, const uint8_t* data, size_t size, off_t offset)
+{
+    size_t written = 0;
+    while (written < size)
+    {
+        ssize_t result = pwrite(fd, data + written, size - written, offset + written);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            perror("Session log write");
+            return false;
+        }
+        written += result;
+    }
+    return true;
+}
+
+static bool syncData(int fd)
+{
+    if (fdatasync(fd) < 0)
+    {
+        perror("Session log sync");
+        return false;
+    }
+    return true;
+}
+
+// Writes the records added since the last flush into the open block's place in the file,
+// then its header. A partial block stays open and later flushes append to it; a full one
+// is closed and the next block starts after it.
+bool SessionLogger::writeBlock()
+{
+    LogRecord* records = reinterpret_cast<LogRecord*>(block + sizeof(LogBlockHeader));
+
+    LogBlockHeader header;
+    header.magic = LOG_BLOCK_MAGIC;
+    header.recordCount = blockRecords;
+    header.sequence = blockSequence + 1;
+    header.firstTimestampNs = records[0].timestampNs;
+    header.lastTimestampNs = records[blockRecords - 1].timestampNs;
+    memcpy(block, &header, sizeof(header));
+
+    // Records first, synced, then the header that counts them: the kernel may write back
+    // dirty pages in any order, so without the sync between them a power cut could leave a
+    // header counting records that never reached the disk
+    size_t first = sizeof(LogBlockHeader) + blockFlushedRecords * sizeof(LogRecord);
+    size_t end = sizeof(LogBlockHeader) + blockRecords * sizeof(LogRecord);
+    if (!writeAt(fd, block + first, end - first, blockOffset + first) || !syncData(fd))
+        return false;
+    if (!writeAt(fd, block, sizeof(LogBlockHeader), blockOffset) || !syncData(fd))
+        return false;
+
+    writtenRecords.fetch_add(blockRecords - blockFlushedRecords, std::memory_order_relaxed);
+    writtenBytes.fetch_add(end - first, std::memory_order_relaxed);
+    blockFlushedRecords = blockRecords;
+
+    if (blockRecords == LOG_RECORDS_PER_BLOCK)
+    {
+        blockSequence++;
+        blockOffset += LOG_BLOCK_SIZE;
+        blockRecords = 0;
+        blockFlushedRecords = 0;
+    }
+    return true;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <linux/can.h>
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+
+#include "session_log.h"
+#include "spsc_queue.h"
+
+#define LOG_QUEUE_SIZE 65536 // Records buffered between the CAN and writer threads, several seconds at full bus load
+
+// Writes every received frame to a session log without slowing the CAN thread down.
+// The CAN thread push()es into a lock-free queue; a dedicated writer thread drains it
+// into LOG_BLOCK_SIZE aligned blocks and writes them sequentially, fdatasync()ing each
+// write so the file on disk is never more than flushIntervalMs behind.
+class SessionLogger
+{
+public:
+    ~SessionLogger();
+
+    // Creates path and starts the writer thread. Returns false if the file can't be opened.
+    bool start(const char* path, const char* profile, uint32_t flushIntervalMs);
+
+    // Flushes whatever is queued, writes the last partial block and joins the writer
+    void stop();
+
+    // CAN thread only. Never blocks; counts a drop if the writer has fallen behind.
+    void push(const struct can_frame& frame, uint64_t timestampNs)
+    {
+        LogRecord record;
+        record.timestampNs = timestampNs;
+        record.canId = frame.can_id;
+        record.dlc = frame.can_dlc;
+        record.reserved[0] = record.reserved[1] = record.reserved[2] = 0;
+        for (int i = 0; i < 8; i++)
+            record.data[i] = frame.data[i];
+
+        if (!queue.push(record))
+            droppedRecords.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool isRunning() const
+    {
+        return fd >= 0;
+    }
+
+    std::atomic<uint64_t> writtenRecords{0};
+    std::atomic<uint64_t> droppedRecords{0};
+    std::atomic<uint64_t> writtenBytes{0};
+
+private:
+    void writerLoop();
+    bool writeBlock();
+
+    SpscQueue<LogRecord, LOG_QUEUE_SIZE> queue;
+    std::thread writerThread;
+    std::atomic<bool> stopping{false};
+    int fd = -1;
+    uint32_t flushIntervalMs = 0;
+
+    // Block being filled, LOG_BLOCK_SIZE aligned so it can go straight to disk
+    uint8_t* block = nullptr;
+    uint64_t blockOffset = 0;         // File offset of the block being filled
+    uint32_t blockRecords = 0;
+    uint32_t blockFlushedRecords = 0; // Of blockRecords, how many are already on disk
+    uint64_t blockSequence = 0;
+};
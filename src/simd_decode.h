@@ -0,0 +1,92 @@
+#pragma once
+
+#include <linux/can.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Per-word decode parameters for one CAN ID: word w of the payload (bytes 2w, 2w+1,
+// big-endian) becomes raw * scale[w] + bias[w], or 0 if raw == invalid[w]. Unused
+// words have scale 0 and invalid -1, which no 16-bit raw value can match.
+struct alignas(16) WordLanes
+{
+    float scale[4];
+    float bias[4];
+    int32_t invalid[4];
+};
+
+// Scalar reference for decodeWordsBE16, also the fallback on targets without SIMD
+inline void decodeWordsBE16Scalar(const struct can_frame* frames, const WordLanes* const* lanes, size_t count, float (*out)[4])
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        const uint8_t* data = frames[i].data;
+        for (int w = 0; w < 4; w++)
+        {
+            int32_t raw = (data[2 * w] << 8) | data[2 * w + 1];
+            out[i][w] = raw == lanes[i]->invalid[w] ? 0.0f : raw * lanes[i]->scale[w] + lanes[i]->bias[w];
+        }
+    }
+}
+
+// Byte-swaps and scales all four 16-bit words of every frame in one go, frame i using
+// lanes[i] (frames of different IDs can be mixed). One vector op per frame with SSE2 or
+// NEON, two with AVX2. 32-bit Pi OS needs -mfpu=neon for the NEON path to be built,
+// which the Makefile adds for arm (armhf) compilers.
+inline void decodeWordsBE16(const struct can_frame* frames, const WordLanes* const* lanes, size_t count, float (*out)[4])
+{
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    for (; i + 2 <= count; i += 2)
+    {
+        const WordLanes& first = *lanes[i];
+        const WordLanes& second = *lanes[i + 1];
+        __m256i payload = _mm256_set_m128i(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(frames[i + 1].data)),
+                                           _mm_loadl_epi64(reinterpret_cast<const __m128i*>(frames[i].data)));
+        __m256i swapped = _mm256_or_si256(_mm256_slli_epi16(payload, 8), _mm256_srli_epi16(payload, 8));
+        __m256i raw = _mm256_unpacklo_epi16(swapped, _mm256_setzero_si256());
+        __m256i invalid = _mm256_cmpeq_epi32(raw, _mm256_set_m128i(_mm_load_si128(reinterpret_cast<const __m128i*>(second.invalid)),
+                                                                   _mm_load_si128(reinterpret_cast<const __m128i*>(first.invalid))));
+        __m256 value = _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(raw), _mm256_set_m128(_mm_load_ps(second.scale), _mm_load_ps(first.scale))),
+                                     _mm256_set_m128(_mm_load_ps(second.bias), _mm_load_ps(first.bias)));
+        value = _mm256_andnot_ps(_mm256_castsi256_ps(invalid), value);
+        _mm_storeu_ps(out[i], _mm256_castps256_ps128(value));
+        _mm_storeu_ps(out[i + 1], _mm256_extractf128_ps(value, 1));
+    }
+#endif
+
+#if defined(__SSE2__)
+    for (; i < count; i++)
+    {
+        const WordLanes& lane = *lanes[i];
+        __m128i payload = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(frames[i].data));
+        __m128i swapped = _mm_or_si128(_mm_slli_epi16(payload, 8), _mm_srli_epi16(payload, 8));
+        __m128i raw = _mm_unpacklo_epi16(swapped, _mm_setzero_si128());
+        __m128i invalid = _mm_cmpeq_epi32(raw, _mm_load_si128(reinterpret_cast<const __m128i*>(lane.invalid)));
+        __m128 value = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(raw), _mm_load_ps(lane.scale)), _mm_load_ps(lane.bias));
+        value = _mm_andnot_ps(_mm_castsi128_ps(invalid), value);
+        _mm_storeu_ps(out[i], value);
+    }
+#elif defined(__ARM_NEON)
+    for (; i < count; i++)
+    {
+        const WordLanes& lane = *lanes[i];
+        uint16x4_t swapped = vreinterpret_u16_u8(vrev16_u8(vld1_u8(frames[i].data)));
+        uint32x4_t raw = vmovl_u16(swapped);
+        uint32x4_t invalid = vceqq_u32(raw, vreinterpretq_u32_s32(vld1q_s32(lane.invalid)));
+        float32x4_t value = vaddq_f32(vmulq_f32(vcvtq_f32_u32(raw), vld1q_f32(lane.scale)), vld1q_f32(lane.bias));
+        value = vreinterpretq_f32_u32(vbicq_u32(vreinterpretq_u32_f32(value), invalid));
+        vst1q_f32(out[i], value);
+    }
+#endif
+
+    decodeWordsBE16Scalar(frames + i, lanes + i, count - i, out + i);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Single-writer / multi-reader publication of a trivially copyable struct (seqlock).
+// The writer never waits on readers: publish() bumps the sequence to odd, copies the
+// payload and bumps it back to even. Readers retry if the sequence was odd or changed
+// while they were copying, so every read() returns one complete publish().
+// The payload is held in relaxed atomic words so concurrent copies are not a data race.
+template <typename T>
+class SnapshotBuffer
+{
+    static_assert(std::is_trivially_copyable<T>::value, "SnapshotBuffer needs a trivially copyable type");
+
+public:
+    SnapshotBuffer()
+    {
+        publish(T());
+    }
+
+    // Writer thread only
+    void publish(const T& value)
+    {
+        uint64_t buffer[WORD_COUNT] = {};
+        memcpy(buffer, &value, sizeof(T));
+
+        uint32_t seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < WORD_COUNT; i++)
+            words[i].store(buffer[i], std::memory_order_relaxed);
+
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    // Any thread; returns a coherent copy of the latest publish()
+    T read() const
+    {
+        uint64_t buffer[WORD_COUNT];
+        uint32_t before, after;
+
+        do {
+            before = sequence.load(std::memory_order_acquire);
+            for (size_t i = 0; i < WORD_COUNT; i++)
+                buffer[i] = words[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+
+        T value;
+        memcpy(&value, buffer, sizeof(T));
+        return value;
+    }
+
+    // Number of completed publishes, handy for spotting "nothing new since last frame"
+    uint32_t version() const
+    {
+        return sequence.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    static const size_t WORD_COUNT = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint32_t> sequence{0};
+    std::atomic<uint64_t> words[WORD_COUNT];
+};
@@ -0,0 +1,324 @@
+#include "socketcan_source.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <linux/net_tstamp.h>
+
+#include "config.h"
+#include "timestamp.h"
+
+SocketCanSource::SocketCanSource()
+{
+    memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < CAN_BATCH_SIZE; i++)
+    {
+        iov[i].iov_len = sizeof(struct can_frame);
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_control = control[i];
+    }
+}
+
+SocketCanSource::~SocketCanSource()
+{
+    for (size_t i = 0; i < interfaceCount; i++)
+        if (interfaces[i].s >= 0)
+            close(interfaces[i].s);
+    if (epollFd >= 0)
+        close(epollFd);
+    if (wakeFd >= 0)
+        close(wakeFd);
+}
+
+bool SocketCanSource::open(const char* ifnames, const std::vector<canid_t>& canIds)
+{
+    const char* cursor = ifnames;
+    while (*cursor)
+    {
+        const char* comma = strchr(cursor, ',');
+        size_t length = comma ? static_cast<size_t>(comma - cursor) : strlen(cursor);
+
+        if (interfaceCount == CAN_MAX_INTERFACES || length == 0 || length >= IFNAMSIZ)
+        {
+            fprintf(stderr, "Bad CAN interface list '%s'\n", ifnames);
+            return false;
+        }
+
+        CanInterface& canInterface = interfaces[interfaceCount++];
+        memcpy(canInterface.name, cursor, length);
+        canInterface.name[length] = '\0';
+        if (!openInterface(canInterface, canIds))
+            return false;
+
+        cursor += length;
+        if (*cursor == ',')
+            cursor++;
+    }
+
+    if (interfaceCount == 0)
+    {
+        fprintf(stderr, "No CAN interface given\n");
+        return false;
+    }
+
+    // Every socket and the interrupt eventfd share one epoll set, so the CAN thread
+    // never blocks somewhere shutdown can't reach
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (epollFd < 0 || wakeFd < 0)
+    {
+        perror("epoll/eventfd");
+        return false;
+    }
+
+    for (size_t i = 0; i <= interfaceCount; i++)
+    {
+        struct epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.u32 = i < interfaceCount ? static_cast<uint32_t>(i) : CAN_WAKE_EVENT;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, i < interfaceCount ? interfaces[i].s : wakeFd, &event) < 0)
+        {
+            perror("epoll_ctl");
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SocketCanSource::openInterface(CanInterface& canInterface, const std::vector<canid_t>& canIds)
+{
+    struct sockaddr_can addr;
+    struct ifreq ifr;
+    int& s = canInterface.s;
+
+    // Create socket
+    if ((s = socket(PF_CAN, SOCK_RAW | SOCK_CLOEXEC, CAN_RAW)) < 0) {
+        perror("Socket creation failed");
+        return false;
+    }
+
+    // Interface setup
+    memset(&ifr, 0, sizeof(ifr));
+    snprintf(ifr.ifr_name, sizeof(ifr.ifr_name), "%s", canInterface.name);
+    if (ioctl(s, SIOCGIFINDEX, &ifr) < 0) {
+        fprintf(stderr, "CAN interface %s: %s\n", canInterface.name, strerror(errno));
+        return false;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = ifr.ifr_ifindex;
+
+    // Stamp every frame with its arrival time
+    enableCanTimestamps(s);
+
+    // Only let the active profile's IDs through
+    if (!canIds.empty() && !applyCanFilter(s, canIds))
+        fprintf(stderr, "CAN interface %s: no kernel filter, receiving all traffic\n", canInterface.name);
+
+    // Bind socket to CAN interface; frames from here on count as seen by us
+    canInterface.rxPacketsAtOpen = readInterfaceRxPackets(canInterface.name);
+    if (bind(s, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        perror("Binding failed");
+        return false;
+    }
+    return true;
+}
+
+uint64_t SocketCanSource::inputFramesSeen(size_t i) const
+{
+    uint64_t rxPackets = readInterfaceRxPackets(interfaces[i].name);
+    return rxPackets > interfaces[i].rxPacketsAtOpen ? rxPackets - interfaces[i].rxPacketsAtOpen : 0;
+}
+
+uint64_t readInterfaceRxPackets(const char* ifname)
+{
+    char path[128];
+    snprintf(path, sizeof(path), "/sys/class/net/%s/statistics/rx_packets", ifname);
+
+    unsigned long long rxPackets = 0;
+    FILE* f = fopen(path, "r");
+    if (f)
+    {
+        if (fscanf(f, "%llu", &rxPackets) != 1)
+            rxPackets = 0;
+        fclose(f);
+    }
+    return rxPackets;
+}
+
+bool applyCanFilter(int s, const std::vector<canid_t>& canIds)
+{
+    std::vector<struct can_filter> filters;
+    // Extended IDs have to match all 29 bits, standard ones 11; the EFF flag keeps the two apart
+    for (canid_t id : canIds)
+        filters.push_back({ id, CAN_EFF_FLAG | CAN_RTR_FLAG | (id & CAN_EFF_FLAG ? CAN_EFF_MASK : CAN_SFF_MASK) });
+
+    if (setsockopt(s, SOL_CAN_RAW, CAN_RAW_FILTER, filters.data(), filters.size() * sizeof(struct can_filter)) < 0)
+    {
+        perror("CAN_RAW_FILTER");
+        return false;
+    }
+    return true;
+}
+
+// SO_TIMESTAMPING gives the software receive time plus the controller's hardware time
+// where the driver supports it; SO_TIMESTAMP is the fallback for kernels/drivers without it.
+void enableCanTimestamps(int s)
+{
+    int flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE
+              | SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+    if (setsockopt(s, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == 0)
+        return;
+
+    int enable = 1;
+    if (setsockopt(s, SOL_SOCKET, SO_TIMESTAMP, &enable, sizeof(enable)) < 0)
+        perror("SO_TIMESTAMP");
+}
+
+// Pulls the receive time out of a message's control data. Software timestamps are
+// used unless config.hardwareTimestamps asks for the controller's clock, which is more
+// precise between frames but is not comparable with the render loop's clock.
+static uint64_t frameTimestampNs(const struct msghdr& msg)
+{
+    uint64_t software = 0, hardware = 0;
+
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(const_cast<struct msghdr*>(&msg), cmsg))
+    {
+        if (cmsg->cmsg_level != SOL_SOCKET)
+            continue;
+
+        if (cmsg->cmsg_type == SO_TIMESTAMPING)
+        {
+            struct scm_timestamping stamps;
+            memcpy(&stamps, CMSG_DATA(cmsg), sizeof(stamps));
+            software = timespecToNs(stamps.ts[0]);
+            hardware = timespecToNs(stamps.ts[2]);
+        } else if (cmsg->cmsg_type == SO_TIMESTAMP) {
+            struct timeval tv;
+            memcpy(&tv, CMSG_DATA(cmsg), sizeof(tv));
+            software = timevalToNs(tv);
+        }
+    }
+
+    if (config.hardwareTimestamps && hardware)
+        return hardware;
+    return software ? software : realtimeNs();
+}
+
+// Reads into batch from offset onwards. Batched mode drains up to limit frames in one
+// recvmmsg(); single mode is one recvmsg() per frame. Returns frames read or -1.
+int SocketCanSource::drain(CanInterface& canInterface, FrameBatch& batch, int offset, int limit, int flags)
+{
+    int count;
+    if (!config.batchedRead)
+    {
+        msgs[offset].msg_hdr.msg_controllen = CAN_CONTROL_SIZE;
+        int nbytesread = recvmsg(canInterface.s, &msgs[offset].msg_hdr, flags);
+        count = nbytesread < 0 ? -1 : (nbytesread > 0 ? 1 : 0);
+    } else {
+        // The kernel shrinks msg_controllen to what it wrote, so reset it every call
+        for (int i = offset; i < offset + limit; i++)
+            msgs[i].msg_hdr.msg_controllen = CAN_CONTROL_SIZE;
+        count = recvmmsg(canInterface.s, msgs + offset, limit, flags, nullptr);
+    }
+
+    if (count < 0)
+        return -1;
+
+    for (int i = offset; i < offset + count; i++)
+        batch.timestamps[i] = frameTimestampNs(msgs[i].msg_hdr);
+
+    canInterface.frames.fetch_add(count, std::memory_order_relaxed);
+    return count;
+}
+
+// Sorts a batch gathered from several buses by arrival time. Each bus's frames are
+// already in order and batches are small, so insertion sort is close to linear.
+static void mergeByTimestamp(FrameBatch& batch, int count)
+{
+    for (int i = 1; i < count; i++)
+    {
+        if (batch.timestamps[i] >= batch.timestamps[i - 1])
+            continue;
+
+        struct can_frame frame = batch.frames[i];
+        uint64_t timestamp = batch.timestamps[i];
+        int j = i;
+        for (; j > 0 && batch.timestamps[j - 1] > timestamp; j--)
+        {
+            batch.frames[j] = batch.frames[j - 1];
+            batch.timestamps[j] = batch.timestamps[j - 1];
+        }
+        batch.frames[j] = frame;
+        batch.timestamps[j] = timestamp;
+    }
+}
+
+int SocketCanSource::receive(FrameBatch& batch)
+{
+    if (boundBatch != &batch)
+    {
+        for (int i = 0; i < CAN_BATCH_SIZE; i++)
+            iov[i].iov_base = &batch.frames[i];
+        boundBatch = &batch;
+    }
+
+    struct epoll_event events[CAN_MAX_INTERFACES + 1];
+    int ready = epoll_wait(epollFd, events, CAN_MAX_INTERFACES + 1, -1);
+    if (ready < 0)
+    {
+        if (errno == EINTR)
+            return 0;
+        perror("epoll_wait");
+        return -1;
+    }
+
+    int readyInterfaces = 0;
+    for (int i = 0; i < ready; i++)
+        readyInterfaces += events[i].data.u32 != CAN_WAKE_EVENT;
+
+    int count = 0;
+    for (int i = 0; i < ready && count < CAN_BATCH_SIZE; i++)
+    {
+        if (events[i].data.u32 == CAN_WAKE_EVENT)
+        {
+            // Consume the wakeup; whoever sent it is about to check running
+            uint64_t wakeups;
+            if (read(wakeFd, &wakeups, sizeof(wakeups)) < 0 && errno != EAGAIN)
+                perror("eventfd read");
+            continue;
+        }
+
+        // Each ready bus gets an even share of what's left, so a busy one can't fill the
+        // batch and leave the others' older frames queued behind it. Whatever is left in a
+        // socket keeps it ready for the next epoll_wait().
+        int share = (CAN_BATCH_SIZE - count) / readyInterfaces--;
+        CanInterface& canInterface = interfaces[events[i].data.u32];
+        int got = drain(canInterface, batch, count, share, MSG_DONTWAIT);
+        if (got < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                continue;
+            fprintf(stderr, "can raw socket read (%s): %s\n", canInterface.name, strerror(errno));
+            return -1;
+        }
+        count += got;
+    }
+
+    if (ready > 1)
+        mergeByTimestamp(batch, count);
+    return count;
+}
+
+void SocketCanSource::interrupt()
+{
+    uint64_t one = 1;
+    if (wakeFd >= 0 && write(wakeFd, &one, sizeof(one)) < 0)
+        perror("eventfd write");
+}
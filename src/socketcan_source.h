@@ -0,0 +1,95 @@
+#pragma once
+
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <time.h>
+#include <linux/errqueue.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <net/if.h>
+#include <stdio.h>
+#include <atomic>
+#include <vector>
+
+#include "frame_source.h"
+
+// Room for both timestamp control messages the kernel may attach
+#define CAN_CONTROL_SIZE (CMSG_SPACE(sizeof(struct scm_timestamping)) + CMSG_SPACE(sizeof(struct timeval)))
+
+#define CAN_MAX_INTERFACES 8
+#define CAN_WAKE_EVENT UINT32_MAX // epoll tag of the interrupt() eventfd
+
+// Frames off one or more CAN_RAW sockets, one per interface (e.g. ECU bus and sensor
+// bus). A single epoll wait services all of them plus an eventfd that interrupt()
+// signals. Each ready bus gets an even share of a batch, and a batch from several buses
+// is merged into arrival order.
+class SocketCanSource : public FrameSource
+{
+public:
+    SocketCanSource();
+    ~SocketCanSource();
+
+    // Opens every interface in the comma separated list ifnames: creates the socket,
+    // turns on receive timestamps, installs a kernel filter for canIds (all traffic if
+    // empty) and binds it
+    bool open(const char* ifnames, const std::vector<canid_t>& canIds);
+
+    int receive(FrameBatch& batch) override;
+
+    void interrupt() override;
+
+    const char* name() const override
+    {
+        return "socketcan";
+    }
+
+    size_t inputCount() const override
+    {
+        return interfaceCount;
+    }
+
+    const char* inputName(size_t i) const override
+    {
+        return interfaces[i].name;
+    }
+
+    uint64_t inputFrames(size_t i) const override
+    {
+        return interfaces[i].frames.load(std::memory_order_relaxed);
+    }
+
+    uint64_t inputFramesSeen(size_t i) const override;
+
+private:
+    struct CanInterface
+    {
+        char name[IFNAMSIZ] = {};
+        int s = -1;
+        std::atomic<uint64_t> frames{0};
+        uint64_t rxPacketsAtOpen = 0; // The interface's counter runs from when it came up, not from open()
+    };
+
+    bool openInterface(CanInterface& canInterface, const std::vector<canid_t>& canIds);
+    int drain(CanInterface& canInterface, FrameBatch& batch, int offset, int limit, int flags);
+
+    CanInterface interfaces[CAN_MAX_INTERFACES];
+    size_t interfaceCount = 0;
+    int epollFd = -1;
+    int wakeFd = -1;
+
+    // recvmmsg() scatter/gather and control buffers, pointed at the batch being filled
+    struct iovec iov[CAN_BATCH_SIZE];
+    struct mmsghdr msgs[CAN_BATCH_SIZE];
+    alignas(struct cmsghdr) char control[CAN_BATCH_SIZE][CAN_CONTROL_SIZE];
+    FrameBatch* boundBatch = nullptr;
+};
+
+// Asks the kernel to stamp every received frame on socket s
+void enableCanTimestamps(int s);
+
+// Total frames the interface has received since it came up, filtered or not (0 if unavailable)
+uint64_t readInterfaceRxPackets(const char* ifname);
+
+// Restricts socket s to canIds, so the rest of the bus traffic is dropped in the
+// kernel before it reaches this process
+bool applyCanFilter(int s, const std::vector<canid_t>& canIds);
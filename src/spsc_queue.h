@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stddef.h>
+#include <atomic>
+
+// Bounded lock-free single-producer / single-consumer queue. push() and pop() never
+// block or allocate; the storage is a fixed array so it is sized once at compile time.
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    // Producer thread only. Returns false (and drops value) if the queue is full.
+    bool push(const T& value)
+    {
+        size_t tail = writeIndex.load(std::memory_order_relaxed);
+        if (tail - cachedReadIndex >= Capacity)
+        {
+            cachedReadIndex = readIndex.load(std::memory_order_acquire);
+            if (tail - cachedReadIndex >= Capacity)
+                return false;
+        }
+
+        items[tail & (Capacity - 1)] = value;
+        writeIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer thread only. Moves up to maxItems into out, returns how many.
+    size_t pop(T* out, size_t maxItems)
+    {
+        size_t head = readIndex.load(std::memory_order_relaxed);
+        size_t available = writeIndex.load(std::memory_order_acquire) - head;
+        if (available > maxItems)
+            available = maxItems;
+
+        for (size_t i = 0; i < available; i++)
+            out[i] = items[(head + i) & (Capacity - 1)];
+
+        readIndex.store(head + available, std::memory_order_release);
+        return available;
+    }
+
+private:
+    // Producer and consumer indices on their own cache lines so they don't ping-pong
+    alignas(64) std::atomic<size_t> writeIndex{0};
+    size_t cachedReadIndex = 0; // Producer's last view of readIndex, saves a shared load per push
+    alignas(64) std::atomic<size_t> readIndex{0};
+    alignas(64) T items[Capacity];
+};
@@ -0,0 +1,113 @@
+#include "synthetic_source.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+#include "timestamp.h"
+
+#define SYNTHETIC_MAX_WAIT std::chrono::milliseconds(100) // Longest receive() sleeps before returning 0
+#define SYNTHETIC_SWEEP_MAX 10000
+#define SYNTHETIC_SWEEP_PERIOD_S 4.0
+
+SyntheticSource::SyntheticSource(const std::vector<Stream>& config)
+{
+    startedAt = std::chrono::steady_clock::now();
+    for (const Stream& stream : config)
+    {
+        if (stream.rateHz <= 0.0)
+            continue;
+        StreamState state;
+        state.canId = stream.canId;
+        state.period = std::chrono::nanoseconds(static_cast<int64_t>(1e9 / stream.rateHz));
+        state.nextDue = startedAt;
+        state.sent = 0;
+        streams.push_back(state);
+    }
+}
+
+bool SyntheticSource::parseStreams(const char* spec, std::vector<Stream>& streams)
+{
+    const char* cursor = spec;
+    while (*cursor)
+    {
+        char* end;
+        unsigned long id = strtoul(cursor, &end, 10);
+        if (end == cursor || *end != ':')
+            return false;
+        cursor = end + 1;
+
+        double rate = strtod(cursor, &end);
+        if (end == cursor || rate <= 0.0)
+            return false;
+        cursor = end;
+
+        streams.push_back({ static_cast<canid_t>(id), rate });
+
+        if (*cursor == ',')
+            cursor++;
+        else if (*cursor)
+            return false;
+    }
+    return !streams.empty();
+}
+
+void SyntheticSource::fill(const StreamState& stream, struct can_frame& frame) const
+{
+    memset(&frame, 0, sizeof(frame));
+    frame.can_id = stream.canId;
+    frame.can_dlc = 8;
+
+    double elapsed = std::chrono::duration<double>(stream.nextDue - startedAt).count();
+    for (int word = 0; word < 4; word++)
+    {
+        double phase = elapsed / SYNTHETIC_SWEEP_PERIOD_S + word * 0.25 + (stream.canId % 7) * 0.1;
+        double position = phase - static_cast<long>(phase);
+        double triangle = position < 0.5 ? position * 2.0 : 2.0 - position * 2.0;
+        uint16_t value = static_cast<uint16_t>(triangle * SYNTHETIC_SWEEP_MAX);
+        frame.data[word * 2] = value >> 8;
+        frame.data[word * 2 + 1] = value & 0xFF;
+    }
+}
+
+// Sends every frame that has come due, oldest first, or sleeps until the next one does
+int SyntheticSource::receive(FrameBatch& batch)
+{
+    if (streams.empty())
+    {
+        fprintf(stderr, "Synthetic source has no streams\n");
+        return -1;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    int count = 0;
+    while (count < CAN_BATCH_SIZE)
+    {
+        StreamState* earliest = &streams[0];
+        for (StreamState& stream : streams)
+            if (stream.nextDue < earliest->nextDue)
+                earliest = &stream;
+
+        if (earliest->nextDue > now)
+        {
+            if (count > 0)
+                break;
+            auto wakeAt = earliest->nextDue < now + SYNTHETIC_MAX_WAIT ? earliest->nextDue : now + SYNTHETIC_MAX_WAIT;
+            std::this_thread::sleep_until(wakeAt);
+            now = std::chrono::steady_clock::now();
+            if (earliest->nextDue > now)
+                return 0;
+        }
+
+        fill(*earliest, batch.frames[count]);
+        // Stamp with when the frame was due, so a late wakeup shows up as jitter and data age
+        auto lateBy = std::chrono::duration_cast<std::chrono::nanoseconds>(now - earliest->nextDue).count();
+        batch.timestamps[count] = realtimeNs() - lateBy;
+        count++;
+
+        earliest->sent++;
+        earliest->nextDue += earliest->period;
+    }
+    return count;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <linux/can.h>
+#include <stdint.h>
+#include <chrono>
+#include <vector>
+
+#include "frame_source.h"
+
+// In-process frame generator for load testing and running without any CAN hardware.
+// Each stream sends one CAN ID at a fixed rate. Every big-endian 16-bit word in the
+// payload sweeps a 0..10000 triangle wave (offset per word and per ID) so gauges move.
+class SyntheticSource : public FrameSource
+{
+public:
+    struct Stream
+    {
+        canid_t canId;
+        double rateHz;
+    };
+
+    explicit SyntheticSource(const std::vector<Stream>& streams);
+
+    int receive(FrameBatch& batch) override;
+
+    const char* name() const override
+    {
+        return "synthetic";
+    }
+
+    // "660:100,661:50" -> streams, IDs in decimal like the decoder tables. Returns false on a malformed spec.
+    static bool parseStreams(const char* spec, std::vector<Stream>& streams);
+
+private:
+    struct StreamState
+    {
+        canid_t canId;
+        std::chrono::nanoseconds period;
+        std::chrono::steady_clock::time_point nextDue;
+        uint32_t sent;
+    };
+
+    void fill(const StreamState& stream, struct can_frame& frame) const;
+
+    std::vector<StreamState> streams;
+    std::chrono::steady_clock::time_point startedAt;
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Assertions for the standalone test programs: report where and exit non-zero, so
+// make check stops at the first failing test
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) \
+        { \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            exit(1); \
+        } \
+    } while (0)
+
+// Tests needing something the machine may not have (vcan devices, root) skip instead of failing
+#define SKIP(reason) \
+    do { \
+        printf("skipped: %s\n", reason); \
+        exit(0); \
+    } while (0)
@@ -0,0 +1,136 @@
+// DbcDecoder's parser and decode: assets/civic.dbc must decode random 1632-1634 frames
+// exactly as the built-in Civic profile does, and a small inline DBC checks an Intel
+// signal, a signed signal, a Motorola signal spanning bytes, a 29-bit ID (bit 31 set)
+// and that a multiplexed (m1) signal is skipped, all against hand-worked values.
+//
+//   tests/dbc_test [civic.dbc]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <random>
+
+#include "dbc_decoder.h"
+#include "check.h"
+
+Config config;
+ThermistorTable thermistorTable;
+ChannelScales channelScales;
+
+#define FRAMES 100000
+
+static const char* inlineDbc =
+    "VERSION \"\"\n"
+    "\n"
+    "BU_: ECU DASH\n"
+    "\n"
+    "BO_ 256 Test: 8 ECU\n"
+    " SG_ rpm : 8|16@1+ (1,0) [0|10000] \"rpm\" DASH\n"
+    " SG_ speed : 24|8@1- (1,-10) [0|300] \"km/h\" DASH\n"
+    " SG_ iat : 39|12@0- (0.5,0) [-40|150] \"C\" DASH\n"
+    " SG_ ect m1 : 55|8@0+ (1,0) [0|150] \"C\" DASH\n"
+    "\n"
+    "BO_ 2147484672 Extended: 8 ECU\n"
+    " SG_ voltage : 7|8@0+ (0.1,0) [0|25.5] \"V\" DASH\n";
+
+// The stored value for raw with the DBC's factor and offset: fixed point builds keep the
+// raw field and scale when drawing
+static ChannelValue expected(int64_t raw, float factor, float offset)
+{
+#ifdef FIXED_POINT_DECODE
+    (void)factor;
+    (void)offset;
+    return static_cast<ChannelValue>(raw);
+#else
+    return static_cast<float>(raw) * factor + offset;
+#endif
+}
+
+static void checkCivic(const char* path)
+{
+    DbcDecoder dbc;
+    CHECK(dbc.load(path, nullptr));
+    CHECK(dbc.signalCount() == 8);
+    ProfileDecoder<CivicProfile> profile;
+
+    std::mt19937 rng(1633);
+    for (int n = 0; n < FRAMES; n++)
+    {
+        canid_t canId = 1632 + rng() % 3;
+        uint8_t data[8];
+        for (uint8_t& byte : data)
+            byte = static_cast<uint8_t>(rng());
+        if (n % 100 == 0)
+            data[0] = data[1] = 0xFF; // TPS's invalid raw value, which only the profile knows
+
+        CANBusData fromDbc, fromProfile;
+        dbc.decode(canId, data, n + 1, fromDbc, nullptr);
+        profile.decode(canId, data, n + 1, fromProfile, nullptr);
+        for (int channel = 0; channel < CH_COUNT; channel++)
+        {
+            if (channel == CH_TPS && canId == 1634 && data[0] == 0xFF && data[1] == 0xFF)
+            {
+                CHECK(fromProfile.values[channel] == 0);
+                CHECK(fromDbc.values[channel] == expected(0xFFFF, 1.0f, 0.0f));
+                continue;
+            }
+            CHECK(fromDbc.values[channel] == fromProfile.values[channel]);
+            CHECK(fromDbc.timestampNs[channel] == fromProfile.timestampNs[channel]);
+        }
+    }
+    printf("%s: %d random frames decode as CivicProfile does\n", path, FRAMES);
+}
+
+static void checkInline()
+{
+    char path[] = "/tmp/dbc_test_XXXXXX";
+    int fd = mkstemp(path);
+    CHECK(fd >= 0);
+    FILE* f = fdopen(fd, "w");
+    CHECK(f && fputs(inlineDbc, f) >= 0);
+    fclose(f);
+
+    DbcDecoder dbc;
+    bool loaded = dbc.load(path, nullptr);
+    unlink(path);
+    CHECK(loaded);
+    CHECK(dbc.signalCount() == 4); // ect is multiplexed and skipped
+
+    std::vector<canid_t> ids = dbc.canIds();
+    CHECK(ids.size() == 2);
+    CHECK(ids[0] == 256);
+    CHECK(ids[1] == (0x400 | CAN_EFF_FLAG));
+
+    // rpm: Intel, bits 8-23, so data[1] is the low byte
+    // speed: Intel signed byte 3, 0xFE = -2
+    // iat: Motorola signed, MSB at DBC bit 39 = data[4] bit 7, 12 bits: data[4] and the
+    //      top nibble of data[5], 0xF38 = -200
+    // ect: multiplexed, must stay untouched
+    const uint8_t data[8] = { 0x00, 0x34, 0x12, 0xFE, 0xF3, 0x8A, 0x7F, 0x00 };
+    CANBusData canData;
+    dbc.decode(256, data, 1, canData, nullptr);
+    CHECK(canData.values[CH_RPM] == expected(0x1234, 1.0f, 0.0f));
+    CHECK(canData.values[CH_SPEED] == expected(-2, 1.0f, -10.0f));
+    CHECK(canData.values[CH_IAT] == expected(-200, 0.5f, 0.0f));
+    CHECK(canData.timestampNs[CH_RPM] == 1 && canData.timestampNs[CH_SPEED] == 1 && canData.timestampNs[CH_IAT] == 1);
+    CHECK(canData.timestampNs[CH_ECT] == 0);
+    CHECK(canData.timestampNs[CH_VOLTAGE] == 0);
+
+    // voltage: Motorola byte 0 of the 29-bit message; the 11-bit ID with the same low
+    // bits must not match it
+    const uint8_t voltage[8] = { 125 };
+    dbc.decode(0x400, voltage, 2, canData, nullptr);
+    CHECK(canData.timestampNs[CH_VOLTAGE] == 0);
+    dbc.decode(0x400 | CAN_EFF_FLAG, voltage, 3, canData, nullptr);
+    CHECK(canData.values[CH_VOLTAGE] == expected(125, 0.1f, 0.0f));
+    CHECK(canData.timestampNs[CH_VOLTAGE] == 3);
+    printf("inline DBC: Intel, signed, Motorola, 29-bit and multiplexed signals decode as worked out\n");
+}
+
+int main(int argc, char** argv)
+{
+    checkCivic(argc > 1 ? argv[1] : "../assets/civic.dbc");
+    checkInline();
+    printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,106 @@
+// Fixed point decoding (always built with -DFIXED_POINT_DECODE) against the float
+// decode's formulas, over random Civic frames: linear channels must come out exactly as
+// the float build would show them, lambda and oil temp within half a fixed point step,
+// and oil pressure within float rounding of the exact line.
+
+#include <math.h>
+#include <stdio.h>
+#include <random>
+
+#include "can_decoder.h"
+#include "check.h"
+
+#ifndef FIXED_POINT_DECODE
+#error fixed_point_test must be built with -DFIXED_POINT_DECODE
+#endif
+
+Config config;
+ThermistorTable thermistorTable;
+ChannelScales channelScales;
+
+#define FRAMES 1000000
+
+int main()
+{
+    thermistorTable.build(config.conA, config.conB, config.conC);
+    channelScales = profileChannelScales<CivicProfile>();
+
+    static const canid_t ids[] = { 660, 661, 662, 664, 667, 1632, 1633, 1634, 1636, 1639 };
+    std::mt19937 rng(1632);
+    double worstLambda = 0.0, worstOilTemp = 0.0, worstOilPressure = 0.0;
+
+    for (int n = 0; n < FRAMES; n++)
+    {
+        struct can_frame frame = {};
+        frame.can_id = ids[rng() % (sizeof(ids) / sizeof(ids[0]))];
+        frame.can_dlc = 8;
+        for (uint8_t& byte : frame.data)
+            byte = static_cast<uint8_t>(rng());
+        if (n % 1000 == 0)
+            frame.data[0] = frame.data[1] = 0xFF; // Make sure TPS's invalid raw value comes up
+
+        CANBusData canData;
+        decodeFrame<CivicProfile>(frame, n + 1, canData);
+
+        for (const SignalDef& signal : CivicProfile::signals)
+        {
+            if (signal.canId != frame.can_id)
+                continue;
+
+            uint16_t raw = signal.length == 2 ? concatenateBytes(frame.data[signal.offset], frame.data[signal.offset + 1]) : frame.data[signal.offset];
+            float shown = channelValue(canData, signal.channel);
+            if (raw == signal.invalidRaw)
+            {
+                CHECK(shown == 0.0f);
+                continue;
+            }
+
+            switch (signal.type)
+            {
+                case SIGNAL_LINEAR:
+                    // The float build stores raw * scale + bias; fixed point applies the same
+                    // unit and bias when drawing
+                    CHECK(shown == raw * signal.scale + signal.bias);
+                    break;
+                case SIGNAL_RECIPROCAL:
+                {
+                    if (raw == 0)
+                    {
+                        CHECK(shown == 0.0f);
+                        break;
+                    }
+                    // Half a step, plus float's own rounding of the big values tiny raw readings give
+                    double exact = static_cast<double>(signal.scale) / raw;
+                    double error = fabs(shown - exact);
+                    worstLambda = std::max(worstLambda, error);
+                    CHECK(error <= RECIPROCAL_FIXED_UNIT / 2 + 2e-7 * exact);
+                    break;
+                }
+                case SIGNAL_THERMISTOR:
+                {
+                    double exact = ThermistorTable::steinhartHart(config.conA, config.conB, config.conC, raw);
+                    if (!std::isfinite(exact))
+                        break; // raw 0, the float build shows nonsense there too
+                    double error = fabs(shown - exact);
+                    worstOilTemp = std::max(worstOilTemp, error);
+                    CHECK(error <= THERMISTOR_FIXED_UNIT / 2 + 1e-4 * std::max(1.0, fabs(exact)));
+                    break;
+                }
+                case SIGNAL_PRESSURE_SENDER:
+                {
+                    double ratio = (raw - config.originalLow) / (config.originalHigh - config.originalLow);
+                    double exact = (ratio * (config.desiredHigh - config.desiredLow) + config.desiredLow) * 0.145038;
+                    double error = fabs(shown - exact) / std::max(1.0, fabs(exact));
+                    worstOilPressure = std::max(worstOilPressure, error);
+                    CHECK(error <= 1e-5);
+                    break;
+                }
+            }
+        }
+    }
+
+    printf("%d frames: linear channels exact, worst lambda error %.6f, oil temp %.4f C, oil pressure %.2g relative\n",
+           FRAMES, worstLambda, worstOilTemp, worstOilPressure);
+    printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,121 @@
+// Stress test for ChannelHistory: one writer appending flat out to a small ring so it
+// laps the readers constantly, against reader threads calling read() in a tight loop.
+// Every sample a reader gets must be one whole append() (value matching its timestamp),
+// each read must be consecutive appends oldest first, and readers must never see time
+// go backwards from one read to the next.
+
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "history.h"
+#include "timestamp.h"
+#include "check.h"
+
+#define READER_COUNT 3
+#define CAPACITY 64 // Small enough that the writer laps a reader mid-copy
+#define SECONDS 2
+
+ChannelScales channelScales;
+
+// Append n carries timestamp n, from 1, and a value derived from it
+static ChannelValue valueFor(uint64_t timestampNs)
+{
+    return static_cast<ChannelValue>(timestampNs & 0xFFFF);
+}
+
+struct ReaderStats
+{
+    uint64_t reads = 0;
+    uint64_t samples = 0;
+    uint64_t lapped = 0;
+    uint64_t torn = 0;
+    uint64_t gaps = 0;
+    uint64_t backwards = 0;
+};
+
+static void reader(const ChannelHistory& history, const std::atomic<bool>& running, ReaderStats& stats)
+{
+    uint64_t timestamps[CAPACITY];
+    ChannelValue values[CAPACITY];
+    uint64_t newest = 0;
+    while (running.load(std::memory_order_relaxed))
+    {
+        size_t count = history.read(1, timestamps, values, CAPACITY);
+        stats.reads++;
+        stats.samples += count;
+        if (count < CAPACITY - 1)
+            stats.lapped++; // Dropped what the writer overwrote mid-copy
+        for (size_t i = 0; i < count; i++)
+        {
+            if (values[i] != valueFor(timestamps[i]))
+                stats.torn++;
+            if (i > 0 && timestamps[i] != timestamps[i - 1] + 1)
+                stats.gaps++;
+        }
+        if (count > 0)
+        {
+            if (timestamps[count - 1] < newest)
+                stats.backwards++;
+            newest = timestamps[count - 1];
+        }
+    }
+}
+
+int main()
+{
+    ChannelHistory history;
+    history.init(CAPACITY);
+    CHECK(history.size() == CAPACITY);
+
+    std::atomic<bool> running(true);
+    ReaderStats stats[READER_COUNT];
+    std::vector<std::thread> readers;
+    for (int i = 0; i < READER_COUNT; i++)
+        readers.emplace_back(reader, std::cref(history), std::cref(running), std::ref(stats[i]));
+
+    uint64_t start = realtimeNs();
+    uint64_t appends = 0;
+    while (realtimeNs() - start < SECONDS * 1000000000ull)
+    {
+        for (int i = 0; i < 1000; i++)
+        {
+            appends++;
+            history.append(appends, valueFor(appends));
+        }
+    }
+
+    running = false;
+    for (std::thread& thread : readers)
+        thread.join();
+
+    ReaderStats total;
+    for (const ReaderStats& s : stats)
+    {
+        total.reads += s.reads;
+        total.samples += s.samples;
+        total.lapped += s.lapped;
+        total.torn += s.torn;
+        total.gaps += s.gaps;
+        total.backwards += s.backwards;
+    }
+    printf("writer: %.0f appends/s into %d slots\n", appends / (double)SECONDS, CAPACITY);
+    printf("readers: %d threads, %llu reads, %llu samples, %llu cut short by lapping, %llu torn, %llu gaps, %llu out of order\n",
+           READER_COUNT, (unsigned long long)total.reads, (unsigned long long)total.samples, (unsigned long long)total.lapped,
+           (unsigned long long)total.torn, (unsigned long long)total.gaps, (unsigned long long)total.backwards);
+
+    CHECK(total.torn == 0);
+    CHECK(total.gaps == 0);
+    CHECK(total.backwards == 0);
+    CHECK(total.reads > 0);
+
+    // Once the writer stops, a read gets the capacity - 1 newest samples intact
+    uint64_t timestamps[CAPACITY];
+    ChannelValue values[CAPACITY];
+    size_t count = history.read(1, timestamps, values, CAPACITY);
+    CHECK(count >= CAPACITY - 1);
+    CHECK(timestamps[count - 1] == appends);
+    printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,121 @@
+// Two CAN interfaces read by one SocketCanSource: a busy bus with a backlog much larger
+// than a batch must not starve a quiet one, every batch must come out in arrival order
+// and each bus's frames must arrive complete and in sequence. Run for recvmmsg and
+// recvmsg reads.
+//
+//   sudo ip link add dev vcan0 type vcan && sudo ip link set up vcan0
+//   sudo ip link add dev vcan1 type vcan && sudo ip link set up vcan1
+//   tests/multi_can_test [busy interface] [quiet interface]
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+
+#include "config.h"
+#include "socketcan_source.h"
+#include "check.h"
+
+Config config;
+
+#define BUSY_ID 0x100
+#define QUIET_ID 0x200
+#define BUSY_EVERY 8 // Busy bus frames per quiet bus frame
+#define QUIET_FRAMES 12
+
+static int openSender(const char* ifname)
+{
+    int s = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+    CHECK(s >= 0);
+
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    snprintf(ifr.ifr_name, sizeof(ifr.ifr_name), "%s", ifname);
+    CHECK(ioctl(s, SIOCGIFINDEX, &ifr) == 0);
+
+    struct sockaddr_can addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = ifr.ifr_ifindex;
+    CHECK(bind(s, (struct sockaddr*)&addr, sizeof(addr)) == 0);
+    return s;
+}
+
+static void sendFrame(int s, canid_t id, uint32_t sequence)
+{
+    struct can_frame frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.can_id = id;
+    frame.can_dlc = 8;
+    memcpy(frame.data, &sequence, sizeof(sequence));
+    CHECK(write(s, &frame, sizeof(frame)) == sizeof(frame));
+}
+
+static void run(const char* busy, const char* quiet, bool batched)
+{
+    config.batchedRead = batched;
+    char ifnames[2 * IFNAMSIZ + 1];
+    snprintf(ifnames, sizeof(ifnames), "%s,%s", busy, quiet);
+    SocketCanSource source;
+    CHECK(source.open(ifnames, {}));
+
+    // Queue a backlog on both buses before reading anything, interleaved in time
+    int busySender = openSender(busy), quietSender = openSender(quiet);
+    const uint32_t busyFrames = QUIET_FRAMES * BUSY_EVERY;
+    for (uint32_t n = 0; n < busyFrames; n++)
+    {
+        sendFrame(busySender, BUSY_ID, n);
+        if (n % BUSY_EVERY == BUSY_EVERY - 1)
+            sendFrame(quietSender, QUIET_ID, n / BUSY_EVERY);
+    }
+
+    FrameBatch batch;
+    uint32_t nextBusy = 0, nextQuiet = 0;
+    for (int call = 0; nextBusy < busyFrames || nextQuiet < QUIET_FRAMES; call++)
+    {
+        CHECK(call < 2 * (int)(busyFrames + QUIET_FRAMES)); // Would mean frames went missing
+        int count = source.receive(batch);
+        CHECK(count > 0);
+
+        int quietInBatch = 0;
+        for (int i = 0; i < count; i++)
+        {
+            if (i > 0)
+                CHECK(batch.timestamps[i] >= batch.timestamps[i - 1]);
+
+            uint32_t sequence;
+            memcpy(&sequence, batch.frames[i].data, sizeof(sequence));
+            if (batch.frames[i].can_id == BUSY_ID)
+                CHECK(sequence == nextBusy++);
+            else
+            {
+                CHECK(batch.frames[i].can_id == QUIET_ID);
+                CHECK(sequence == nextQuiet++);
+                quietInBatch++;
+            }
+        }
+
+        // The busy backlog alone is more than a batch; the quiet bus still has to get its
+        // share of the first one
+        if (call == 0)
+            CHECK(quietInBatch == (batched ? QUIET_FRAMES : 1));
+    }
+
+    close(busySender);
+    close(quietSender);
+    printf("%-8s %u + %u frames, batches ordered, quiet bus read first time\n", batched ? "recvmmsg" : "recvmsg", busyFrames, QUIET_FRAMES);
+}
+
+int main(int argc, char** argv)
+{
+    const char* busy = argc > 1 ? argv[1] : "vcan0";
+    const char* quiet = argc > 2 ? argv[2] : "vcan1";
+    if (if_nametoindex(busy) == 0 || if_nametoindex(quiet) == 0)
+        SKIP("needs vcan0 and vcan1 (sudo ip link add dev vcanN type vcan && sudo ip link set up vcanN)");
+
+    alarm(10); // receive() waits forever if frames go missing; fail instead of hanging make check
+    for (bool batched : { true, false })
+        run(busy, quiet, batched);
+    return 0;
+}
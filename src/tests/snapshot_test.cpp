@@ -0,0 +1,143 @@
+// Stress test for SnapshotBuffer: one writer publishing CANBusData at bus rate and then
+// flat out, against reader threads calling read() in a tight loop. Every snapshot a
+// reader gets must be one whole publish() (no fields from two publishes), readers must
+// never see time go backwards, and the writer must keep its schedule however hard the
+// readers hammer.
+
+#include <stdio.h>
+#include <time.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "can_data.h"
+#include "snapshot.h"
+#include "timestamp.h"
+#include "check.h"
+
+#define READER_COUNT 3
+#define BUS_RATE_HZ 8000 // A 1 Mbit/s bus full of 8 byte frames, published one frame at a time
+#define PACED_SECONDS 2
+#define FLAT_OUT_SECONDS 1
+
+ChannelScales channelScales;
+
+// Publish n: every field derived from n, so a reader can tell if fields were mixed
+static CANBusData makeSnapshot(uint64_t n)
+{
+    CANBusData data;
+    for (int i = 0; i < CH_COUNT; i++)
+    {
+        data.values[i] = static_cast<ChannelValue>((n & 0xFFFF) + i);
+        data.timestampNs[i] = n * CH_COUNT + i;
+    }
+    return data;
+}
+
+static bool isWhole(const CANBusData& data)
+{
+    uint64_t n = data.timestampNs[0] / CH_COUNT;
+    for (int i = 0; i < CH_COUNT; i++)
+        if (data.values[i] != static_cast<ChannelValue>((n & 0xFFFF) + i) || data.timestampNs[i] != n * CH_COUNT + i)
+            return false;
+    return true;
+}
+
+struct ReaderStats
+{
+    uint64_t reads = 0;
+    uint64_t torn = 0;
+    uint64_t backwards = 0;
+};
+
+static void reader(const SnapshotBuffer<CANBusData>& snapshot, const std::atomic<bool>& running, ReaderStats& stats)
+{
+    uint64_t last = 0;
+    while (running.load(std::memory_order_relaxed))
+    {
+        CANBusData data = snapshot.read();
+        stats.reads++;
+        if (!isWhole(data))
+            stats.torn++;
+        if (data.timestampNs[0] < last)
+            stats.backwards++;
+        last = data.timestampNs[0];
+    }
+}
+
+static uint64_t monotonicNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return timespecToNs(ts);
+}
+
+int main()
+{
+    SnapshotBuffer<CANBusData> snapshot;
+    snapshot.publish(makeSnapshot(0)); // Replaces the constructor's all-zero T(), which isn't a valid pattern
+    std::atomic<bool> running(true);
+    ReaderStats stats[READER_COUNT];
+    std::vector<std::thread> readers;
+    for (int i = 0; i < READER_COUNT; i++)
+        readers.emplace_back(reader, std::cref(snapshot), std::cref(running), std::ref(stats[i]));
+
+    // Paced: one publish per frame period on an absolute schedule
+    const uint64_t periodNs = 1000000000ull / BUS_RATE_HZ;
+    const uint64_t pacedCount = static_cast<uint64_t>(BUS_RATE_HZ) * PACED_SECONDS;
+    uint64_t n = 1;
+    uint64_t maxPublishNs = 0, maxLateNs = 0;
+    uint64_t start = monotonicNs();
+    for (; n <= pacedCount; n++)
+    {
+        uint64_t due = start + n * periodNs;
+        struct timespec wake = { static_cast<time_t>(due / 1000000000ull), static_cast<long>(due % 1000000000ull) };
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, nullptr);
+
+        uint64_t before = monotonicNs();
+        snapshot.publish(makeSnapshot(n));
+        uint64_t after = monotonicNs();
+        if (after - before > maxPublishNs)
+            maxPublishNs = after - before;
+        if (after > due && after - due > maxLateNs)
+            maxLateNs = after - due;
+    }
+    double pacedSeconds = (monotonicNs() - start) / 1e9;
+
+    // Flat out: as many publishes as the writer can do, readers see the most retries here
+    uint64_t flatOutStart = monotonicNs();
+    uint64_t flatOutCount = 0;
+    while (monotonicNs() - flatOutStart < FLAT_OUT_SECONDS * 1000000000ull)
+    {
+        snapshot.publish(makeSnapshot(n++));
+        flatOutCount++;
+    }
+
+    running = false;
+    for (std::thread& thread : readers)
+        thread.join();
+
+    uint64_t reads = 0, torn = 0, backwards = 0;
+    for (const ReaderStats& s : stats)
+    {
+        reads += s.reads;
+        torn += s.torn;
+        backwards += s.backwards;
+    }
+    printf("paced: %llu publishes at %d Hz in %.3f s, max publish %.1f us, max late %.1f us\n",
+           (unsigned long long)pacedCount, BUS_RATE_HZ, pacedSeconds, maxPublishNs / 1e3, maxLateNs / 1e3);
+    printf("flat out: %.0f publishes/s\n", flatOutCount / (double)FLAT_OUT_SECONDS);
+    printf("readers: %d threads, %llu reads, %llu torn, %llu out of order\n",
+           READER_COUNT, (unsigned long long)reads, (unsigned long long)torn, (unsigned long long)backwards);
+
+    CHECK(torn == 0);
+    CHECK(backwards == 0);
+    CHECK(reads > 0);
+    CHECK(snapshot.version() == n + 1); // Constructor's publish plus 0..n-1
+    // The writer never waits for readers, so keeping the bus schedule only depends on
+    // getting the CPU: allow scheduler noise, not a stall
+    CHECK(pacedSeconds < PACED_SECONDS * 1.1);
+    CHECK(maxLateNs < 50000000ull);
+    printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,48 @@
+// ThermistorTable against the exact Steinhart-Hart formula for every 16-bit raw reading,
+// with the dash's oil temp sensor coefficients from Config
+
+#include <math.h>
+#include <stdio.h>
+
+#include "config.h"
+#include "thermistor.h"
+#include "check.h"
+
+Config config;
+
+int main()
+{
+    ThermistorTable table;
+    table.build(config.conA, config.conB, config.conC);
+
+#ifdef FIXED_POINT_DECODE
+    const double tolerance = THERMISTOR_FIXED_UNIT / 2 + 1e-6; // Rounded to hundredths of a degree
+#else
+    const double tolerance = 1e-3; // float keeps ~7 digits, i.e. well under a thousandth of a degree here
+#endif
+
+    double worstError = 0.0;
+    uint32_t worstRaw = 0;
+    for (uint32_t raw = 0; raw < 65536; raw++)
+    {
+        double exact = ThermistorTable::steinhartHart(config.conA, config.conB, config.conC, raw);
+#ifdef FIXED_POINT_DECODE
+        double tableValue = table.lookup(static_cast<uint16_t>(raw)) * static_cast<double>(THERMISTOR_FIXED_UNIT);
+#else
+        double tableValue = table.lookup(static_cast<uint16_t>(raw));
+#endif
+        CHECK(std::isfinite(tableValue));
+        double error = fabs(tableValue - exact);
+        if (error > worstError)
+        {
+            worstError = error;
+            worstRaw = raw;
+        }
+    }
+
+    printf("65536 raw values, worst error %.6f C at raw %u (%.3f C)\n", worstError, worstRaw,
+           ThermistorTable::steinhartHart(config.conA, config.conB, config.conC, worstRaw));
+    CHECK(worstError <= tolerance);
+    printf("ok\n");
+    return 0;
+}
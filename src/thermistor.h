@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "can_data.h"
+
+#define THERMISTOR_FIXED_UNIT 0.01f // C per step of a fixed point thermistor value
+
+// Steinhart-Hart curve precomputed for every 16-bit raw reading, so decoding a
+// thermistor channel is one load instead of two log() and a pow() per frame.
+// Build once at startup from the sensor's coefficients; any channel that reports
+// the raw 16-bit resistance can share a table built for its sensor. Fixed point builds
+// store hundredths of a degree instead of floats.
+class ThermistorTable
+{
+public:
+    void build(double a, double b, double c)
+    {
+        celsius.resize(65536);
+        for (uint32_t raw = 0; raw < 65536; raw++)
+        {
+            double value = steinhartHart(a, b, c, raw);
+#ifdef FIXED_POINT_DECODE
+            celsius[raw] = static_cast<ChannelValue>(lround(value / THERMISTOR_FIXED_UNIT));
+#else
+            celsius[raw] = static_cast<ChannelValue>(value);
+#endif
+        }
+    }
+
+    ChannelValue lookup(uint16_t raw) const
+    {
+        return celsius[raw];
+    }
+
+    // Exact formula the table is built from, result in C
+    static double steinhartHart(double a, double b, double c, double resistance)
+    {
+        double logR = log(resistance);
+        double kelvinTemp = 1.0 / (a + b * logR + c * logR * logR * logR);
+        return kelvinTemp - 273.15;
+    }
+
+private:
+    std::vector<ChannelValue> celsius;
+};
+
+// Built from config.conA/B/C in main() before the CAN thread starts
+extern ThermistorTable thermistorTable;
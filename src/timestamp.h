@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+#include <sys/time.h>
+
+// All timestamps in the dash are nanoseconds on CLOCK_REALTIME, the clock the kernel
+// uses for socket receive timestamps, so frame arrival and render times compare directly.
+
+inline uint64_t timespecToNs(const struct timespec& ts)
+{
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+inline uint64_t timevalToNs(const struct timeval& tv)
+{
+    return static_cast<uint64_t>(tv.tv_sec) * 1000000000ull + static_cast<uint64_t>(tv.tv_usec) * 1000ull;
+}
+
+inline uint64_t realtimeNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return timespecToNs(ts);
+}